@@ -0,0 +1,451 @@
+// tiny3d_bench
+// Measures the throughput of the tiny3d rendering functions on reproducible synthetic workloads and prints the results as CSV or JSON.
+// Build from the repository root, e.g.
+//   g++ -O2 -std=c++11 -I. bench/tiny3d_bench.cpp tiny_*.cpp -pthread -o tiny3d_bench
+// Usage:
+//   tiny3d_bench [--json] [--time seconds] [--size WxH] [--simd sse|avx2|avx512] [--filter text]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "tiny3d.h"
+
+using namespace tiny3d;
+
+// @data Options
+// @info The command line options.
+struct Options
+{
+	double      min_time = 0.25;    // the minimum time in seconds spent measuring each workload
+	UInt        width    = 640;     // the dimensions of the destination image
+	UInt        height   = 480;
+	bool        json     = false;   // print JSON instead of CSV
+	const char *filter   = nullptr; // only run workloads containing this text
+};
+
+// @data Result
+// @info The measurement of one workload.
+struct Result
+{
+	std::string workload;
+	std::string function;
+	UInt        ops;      // the number of operations measured
+	double      seconds;  // the time spent on the operations
+	double      pixels;   // the number of pixels covered by the operations
+	double      tris;     // the number of triangles submitted by the operations
+};
+
+// @data Shading
+// @info How the triangles of a workload are shaded.
+enum Shading
+{
+	Shading_Untextured,
+	Shading_Textured,
+	Shading_Lightmapped
+};
+
+// @data Depth
+// @info The depth buffer used by a workload.
+enum Depth
+{
+	Depth_None,
+	Depth_Z32, // Array<float>
+	Depth_Z16  // Array<UHInt>
+};
+
+// @data Scene
+// @info The render targets and resources shared by all workloads.
+struct Scene
+{
+	Image          dst;
+	Array<float>   z32;
+	Array<UHInt>   z16;
+	Texture        tex;
+	Texture        lightmap;
+	Image          src_image;
+	Overlay        src_overlay;
+};
+
+// @data Triangles
+// @info A list of triangles, three vertices per triangle, and the number of pixels they cover.
+struct Triangles
+{
+	std::vector<Vertex>  v;
+	std::vector<LVertex> l;
+	double               area = 0.0;
+};
+
+// @algo Random
+// @info A linear congruential generator, so that every run renders the same workloads on every platform.
+// @inout seed -> The state of the generator.
+// @out A number in the range [0, 1).
+float Random(UInt &seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return float(seed >> 8) / float(1 << 24);
+}
+
+// @algo AddTriangle
+// @info Adds a triangle to the list. Texture and light map coordinates are derived from the screen coordinates.
+void AddTriangle(Triangles &out, const Vector3 (&p)[3], const Color (&c)[3], const Options &opt)
+{
+	for (UInt i = 0; i < 3; ++i) {
+		Vertex v;
+		v.v = p[i];
+		v.t = Vector2(p[i].x / opt.width, p[i].y / opt.height);
+		v.c = c[i];
+		LVertex l;
+		l.v = v.v;
+		l.t = v.t;
+		l.l = v.t;
+		out.v.push_back(v);
+		out.l.push_back(l);
+	}
+	const float area = ((p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y)) * 0.5f;
+	out.area += area < 0.0f ? -area : area;
+}
+
+// @algo MakeFill
+// @info Creates screen covering quads, drawn back to front so that every layer passes the depth test.
+// @out The triangles.
+Triangles MakeFill(UInt layers, const Options &opt)
+{
+	Triangles out;
+	const float w = float(opt.width);
+	const float h = float(opt.height);
+	for (UInt i = 0; i < layers; ++i) {
+		const float z = float(layers - i);
+		const Color c0 = { 255, 0, 0, Color::Solid }, c1 = { 0, 255, 0, Color::Solid }, c2 = { 0, 0, 255, Color::Solid }, c3 = { 255, 255, 255, Color::Solid };
+		const Vector3 a[3] = { Vector3(0.0f, 0.0f, z), Vector3(w, 0.0f, z), Vector3(w, h, z) };
+		const Vector3 b[3] = { Vector3(0.0f, 0.0f, z), Vector3(w, h, z), Vector3(0.0f, h, z) };
+		const Color ca[3] = { c0, c1, c2 };
+		const Color cb[3] = { c0, c2, c3 };
+		AddTriangle(out, a, ca, opt);
+		AddTriangle(out, b, cb, opt);
+	}
+	return out;
+}
+
+// @algo MakeTiny
+// @info Creates small triangles a few pixels across scattered over the screen, as produced by distant geometry in dense meshes.
+// @out The triangles.
+Triangles MakeTiny(UInt count, const Options &opt)
+{
+	Triangles out;
+	UInt seed = 1;
+	for (UInt i = 0; i < count; ++i) {
+		const float x = 4.0f + Random(seed) * (opt.width - 8);
+		const float y = 4.0f + Random(seed) * (opt.height - 8);
+		const float z = 1.0f + Random(seed) * 15.0f;
+		Vector3 p[3];
+		Color c[3];
+		for (UInt j = 0; j < 3; ++j) {
+			p[j] = Vector3(x + Random(seed) * 6.0f - 3.0f, y + Random(seed) * 6.0f - 3.0f, z);
+			c[j] = Color{ Byte(Random(seed) * 255), Byte(Random(seed) * 255), Byte(Random(seed) * 255), Color::Solid };
+		}
+		AddTriangle(out, p, c, opt);
+	}
+	return out;
+}
+
+// @algo Clear
+// @info Clears the destination image and depth buffers between iterations of a workload.
+void Clear(Scene &scene)
+{
+	scene.dst.Fill(Color{ 0, 0, 0, Color::Solid });
+	for (UInt i = 0; i < scene.z32.GetSize(); ++i) { scene.z32[i] = std::numeric_limits<float>::infinity(); }
+	for (UInt i = 0; i < scene.z16.GetSize(); ++i) { scene.z16[i] = 0xffff; }
+}
+
+// @algo Draw
+// @info Draws a list of triangles with either DrawTriangle or DrawTriangle_Fast.
+template < typename depth_t >
+void Draw(Scene &scene, Array<depth_t> *z, const Triangles &tris, Shading shading, bool fast)
+{
+	const Texture *tex = shading == Shading_Untextured ? nullptr : &scene.tex;
+	const UInt n = UInt(tris.v.size());
+	if (shading == Shading_Lightmapped) {
+		const LVertex *l = tris.l.data();
+		for (UInt i = 0; i < n; i += 3) {
+			if (fast) { DrawTriangle_Fast(scene.dst, z, z, l[i], l[i + 1], l[i + 2], tex, scene.lightmap, nullptr, PerspectiveMode_Correct, DepthFormat_Z, nullptr, CullMode_None); }
+			else      { DrawTriangle(scene.dst, z, z, l[i], l[i + 1], l[i + 2], tex, scene.lightmap, nullptr, DepthFormat_Z, CullMode_None); }
+		}
+	} else {
+		const Vertex *v = tris.v.data();
+		for (UInt i = 0; i < n; i += 3) {
+			if (fast) { DrawTriangle_Fast(scene.dst, z, z, v[i], v[i + 1], v[i + 2], tex, nullptr, PerspectiveMode_Correct, DepthFormat_Z, nullptr, CullMode_None); }
+			else      { DrawTriangle(scene.dst, z, z, v[i], v[i + 1], v[i + 2], tex, nullptr, DepthFormat_Z, CullMode_None); }
+		}
+	}
+}
+
+// @algo Measure
+// @info Runs an operation repeatedly until the minimum time has passed. Only the time spent in the operation itself is measured.
+// @in
+//   reset -> Called before every iteration, outside of the measured time.
+//   run -> Runs one iteration.
+//   ops_per_run, pixels_per_run, tris_per_run -> The work done by one iteration.
+// @out The measurement.
+template < typename reset_t, typename run_t >
+Result Measure(const Options &opt, const char *workload, const char *function, reset_t reset, run_t run, UInt ops_per_run, double pixels_per_run, double tris_per_run)
+{
+	typedef std::chrono::steady_clock clock;
+	reset();
+	run(); // warm up caches and the SIMD level selection
+	UInt runs = 0;
+	double seconds = 0.0;
+	while (seconds < opt.min_time) {
+		reset();
+		const clock::time_point start = clock::now();
+		run();
+		seconds += std::chrono::duration<double>(clock::now() - start).count();
+		++runs;
+	}
+	Result r;
+	r.workload = workload;
+	r.function = function;
+	r.ops      = runs * ops_per_run;
+	r.seconds  = seconds;
+	r.pixels   = runs * pixels_per_run;
+	r.tris     = runs * tris_per_run;
+	return r;
+}
+
+// @algo Selected
+// @out TRUE if the workload matches the filter.
+bool Selected(const Options &opt, const std::string &name)
+{
+	return opt.filter == nullptr || name.find(opt.filter) != std::string::npos;
+}
+
+// @algo RunTriangles
+// @info Measures a list of triangles for one shading and depth buffer, with both DrawTriangle and DrawTriangle_Fast.
+void RunTriangles(std::vector<Result> &results, Scene &scene, const Options &opt, const char *set, const Triangles &tris, Shading shading, Depth depth)
+{
+	static const char *SHADING[] = { "untextured", "textured", "lightmapped" };
+	static const char *DEPTH[]   = { "nodepth", "z32", "z16" };
+	const std::string name = std::string(set) + "/" + SHADING[shading] + "/" + DEPTH[depth];
+	const UInt ntris = UInt(tris.v.size() / 3);
+	for (UInt fast = 0; fast < 2; ++fast) {
+		const char *function = fast ? "DrawTriangle_Fast" : "DrawTriangle";
+		if (!Selected(opt, name + "/" + function)) { continue; }
+		auto reset = [&]() { Clear(scene); };
+		auto run = [&]() {
+			switch (depth) {
+			case Depth_None: Draw<float>(scene, nullptr, tris, shading, fast != 0); break;
+			case Depth_Z32:  Draw(scene, &scene.z32, tris, shading, fast != 0); break;
+			case Depth_Z16:  Draw(scene, &scene.z16, tris, shading, fast != 0); break;
+			}
+		};
+		results.push_back(Measure(opt, name.c_str(), function, reset, run, ntris, tris.area, ntris));
+	}
+}
+
+// @algo RunBlendModes
+// @info Measures screen covering textured triangles with every blend mode of the texture.
+void RunBlendModes(std::vector<Result> &results, Scene &scene, const Options &opt, const Triangles &tris)
+{
+	static const char *BLEND[] = { "transparent", "emissive", "addalpha", "solid", "emissiveaddalpha" };
+	for (UInt mode = Color::Transparent; mode <= Color::EmissiveAddAlpha; ++mode) {
+		scene.tex.SetBlendMode1(Color::BlendMode(mode));
+		scene.tex.SetBlendMode2(Color::BlendMode(mode));
+		RunTriangles(results, scene, opt, (std::string("blend_") + BLEND[mode]).c_str(), tris, Shading_Textured, Depth_None);
+	}
+	scene.tex.SetBlendMode1(Color::Solid);
+	scene.tex.SetBlendMode2(Color::Solid);
+}
+
+// @algo RunRegions
+// @info Measures DrawRegion blits of images and overlays to the full destination image.
+void RunRegions(std::vector<Result> &results, Scene &scene, const Options &opt)
+{
+	const Rect dst_region = { { 0, 0 }, { SInt(opt.width), SInt(opt.height) } };
+	const double pixels = double(opt.width) * opt.height;
+	const UInt sw = scene.src_image.GetWidth(), sh = scene.src_image.GetHeight();
+	const Rect full_region = { { 0, 0 }, { SInt(sw), SInt(sh) } };
+	const Rect part_region = { { 0, 0 }, { SInt(sw / 4), SInt(sh / 4) } };
+	auto reset = [&]() { Clear(scene); };
+	if (Selected(opt, "region/image_1x/DrawRegion")) {
+		results.push_back(Measure(opt, "region/image_1x", "DrawRegion", reset, [&]() { DrawRegion(scene.dst, dst_region, scene.src_image, full_region); }, 1, pixels, 0.0));
+	}
+	if (Selected(opt, "region/image_4x/DrawRegion")) {
+		results.push_back(Measure(opt, "region/image_4x", "DrawRegion", reset, [&]() { DrawRegion(scene.dst, dst_region, scene.src_image, part_region); }, 1, pixels, 0.0));
+	}
+	if (Selected(opt, "region/overlay_4x/DrawRegion")) {
+		const Rect overlay_region = { { 0, 0 }, { SInt(scene.src_overlay.GetWidth()), SInt(scene.src_overlay.GetHeight()) } };
+		results.push_back(Measure(opt, "region/overlay_4x", "DrawRegion", reset, [&]() { DrawRegion(scene.dst, dst_region, scene.src_overlay, overlay_region); }, 1, pixels, 0.0));
+	}
+}
+
+// @algo RunChars
+// @info Measures DrawChars filling the destination image with text at integer scales.
+void RunChars(std::vector<Result> &results, Scene &scene, const Options &opt)
+{
+	static const char *LINE = "The quick brown fox jumps over the lazy dog. 0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+	for (UInt scale = 1; scale <= 2; ++scale) {
+		const std::string name = "chars/scale" + std::to_string(scale);
+		if (!Selected(opt, name + "/DrawChars")) { continue; }
+		const UInt cols = opt.width / (TINY3D_CHAR_WIDTH * scale);
+		const UInt rows = opt.height / (TINY3D_CHAR_HEIGHT * scale);
+		std::string text;
+		for (UInt y = 0; y < rows; ++y) {
+			for (UInt x = 0; x < cols; ++x) { text += LINE[(x + y) % std::strlen(LINE)]; }
+			text += '\n';
+		}
+		const Color color = { 255, 255, 255, Color::Solid };
+		const double pixels = double(cols * rows) * TINY3D_CHAR_WIDTH * TINY3D_CHAR_HEIGHT * scale * scale;
+		auto reset = [&]() { Clear(scene); };
+		auto run = [&]() { DrawChars(scene.dst, Point{ 0, 0 }, 0, text.c_str(), UInt(text.size()), color, scale); };
+		results.push_back(Measure(opt, name.c_str(), "DrawChars", reset, run, 1, pixels, 0.0));
+	}
+}
+
+// @algo RunFromImage
+// @info Measures the compression of images to textures.
+void RunFromImage(std::vector<Result> &results, const Options &opt)
+{
+	for (UInt dim = 64; dim <= 256; dim *= 4) {
+		const std::string name = "texture/from_image_" + std::to_string(dim);
+		if (!Selected(opt, name + "/Texture::FromImage")) { continue; }
+		Image img(dim);
+		UInt seed = dim;
+		for (UInt y = 0; y < dim; ++y) {
+			for (UInt x = 0; x < dim; ++x) {
+				img.SetColor(UPoint{ x, y }, Color{ Byte(x * 255 / dim), Byte(y * 255 / dim), Byte(Random(seed) * 255), Color::Solid });
+			}
+		}
+		Texture tex;
+		results.push_back(Measure(opt, name.c_str(), "Texture::FromImage", []() {}, [&]() { tex.FromImage(img); }, 1, double(dim) * dim, 0.0));
+	}
+}
+
+// @algo CreateScene
+// @info Creates the render targets and a procedural texture, light map, image and overlay.
+void CreateScene(Scene &scene, const Options &opt)
+{
+	scene.dst.Create(opt.width, opt.height);
+	scene.z32.Create(opt.width * opt.height);
+	scene.z16.Create(opt.width * opt.height);
+
+	Image img(64);
+	for (UInt y = 0; y < 64; ++y) {
+		for (UInt x = 0; x < 64; ++x) {
+			img.SetColor(UPoint{ x, y }, ((x ^ y) & 8) ? Color{ 255, 192, 64, Color::Solid } : Color{ 32, 64, 160, Color::Solid });
+		}
+	}
+	scene.tex.FromImage(img);
+	for (UInt y = 0; y < 64; ++y) {
+		for (UInt x = 0; x < 64; ++x) {
+			const Byte l = Byte(64 + ((x + y) * 191) / 126);
+			img.SetColor(UPoint{ x, y }, Color{ l, l, l, Color::Solid });
+		}
+	}
+	scene.lightmap.FromImage(img);
+
+	scene.src_image.Create(opt.width, opt.height);
+	scene.src_overlay.Create(opt.width / 4, opt.height / 4);
+	for (UInt y = 0; y < opt.height; ++y) {
+		for (UInt x = 0; x < opt.width; ++x) {
+			scene.src_image.SetColor(UPoint{ x, y }, Color{ Byte(x), Byte(y), Byte(x ^ y), ((x ^ y) & 16) ? Color::Solid : Color::Transparent });
+		}
+	}
+	for (UInt y = 0; y < scene.src_overlay.GetHeight(); ++y) {
+		for (UInt x = 0; x < scene.src_overlay.GetWidth(); ++x) {
+			scene.src_overlay.SetBit(UPoint{ x, y }, ((x ^ y) & 4) != 0);
+		}
+	}
+}
+
+// @algo Print
+// @info Prints the results as CSV, or as JSON.
+void Print(const std::vector<Result> &results, const Options &opt)
+{
+	const char *simd = GetSIMDLevelName(GetSIMDLevel());
+	if (opt.json) {
+		std::printf("{\n\t\"simd\": \"%s\",\n\t\"width\": %u,\n\t\"height\": %u,\n\t\"results\": [\n", simd, opt.width, opt.height);
+	} else {
+		std::printf("workload,function,simd,ops,ns_per_op,mtris_per_s,mpixels_per_s\n");
+	}
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result &r = results[i];
+		const double ns_per_op = r.seconds * 1e9 / r.ops;
+		const double mtris     = r.tris / r.seconds * 1e-6;
+		const double mpixels   = r.pixels / r.seconds * 1e-6;
+		if (opt.json) {
+			std::printf("\t\t{ \"workload\": \"%s\", \"function\": \"%s\", \"ops\": %u, \"ns_per_op\": %.3f, \"mtris_per_s\": %.6f, \"mpixels_per_s\": %.3f }%s\n", r.workload.c_str(), r.function.c_str(), r.ops, ns_per_op, mtris, mpixels, i + 1 < results.size() ? "," : "");
+		} else {
+			std::printf("%s,%s,%s,%u,%.3f,%.6f,%.3f\n", r.workload.c_str(), r.function.c_str(), simd, r.ops, ns_per_op, mtris, mpixels);
+		}
+	}
+	if (opt.json) {
+		std::printf("\t]\n}\n");
+	}
+}
+
+// @algo ParseOptions
+// @out TRUE if the command line is valid.
+bool ParseOptions(int argc, char **argv, Options &opt)
+{
+	for (int i = 1; i < argc; ++i) {
+		const bool has_value = i + 1 < argc;
+		if (std::strcmp(argv[i], "--json") == 0) {
+			opt.json = true;
+		} else if (std::strcmp(argv[i], "--time") == 0 && has_value) {
+			opt.min_time = std::atof(argv[++i]);
+		} else if (std::strcmp(argv[i], "--size") == 0 && has_value) {
+			if (std::sscanf(argv[++i], "%ux%u", &opt.width, &opt.height) != 2 || opt.width < 16 || opt.height < 16) { return false; }
+		} else if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+			opt.filter = argv[++i];
+		} else if (std::strcmp(argv[i], "--simd") == 0 && has_value) {
+			const char *name = argv[++i];
+			bool found = false;
+			for (SIMDLevel level : { SIMDLevel_None, SIMDLevel_SSE, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON, SIMDLevel_AltiVec }) {
+				if (std::strcmp(name, GetSIMDLevelName(level)) == 0) {
+					found = SetSIMDLevel(level);
+					break;
+				}
+			}
+			if (!found) {
+				std::fprintf(stderr, "SIMD level %s is not supported\n", name);
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	if (!ParseOptions(argc, argv, opt)) {
+		std::fprintf(stderr, "usage: %s [--json] [--time seconds] [--size WxH] [--simd sse|avx2|avx512] [--filter text]\n", argv[0]);
+		return 1;
+	}
+
+	Scene scene;
+	CreateScene(scene, opt);
+
+	const Triangles fill = MakeFill(4, opt);
+	const Triangles tiny = MakeTiny(20000, opt);
+
+	std::vector<Result> results;
+	for (UInt shading = Shading_Untextured; shading <= Shading_Lightmapped; ++shading) {
+		for (UInt depth = Depth_None; depth <= Depth_Z16; ++depth) {
+			RunTriangles(results, scene, opt, "fill", fill, Shading(shading), Depth(depth));
+			RunTriangles(results, scene, opt, "tiny", tiny, Shading(shading), Depth(depth));
+		}
+	}
+	RunBlendModes(results, scene, opt, fill);
+	RunRegions(results, scene, opt);
+	RunChars(results, scene, opt);
+	RunFromImage(results, opt);
+
+	Print(results, opt);
+	return 0;
+}
@@ -0,0 +1,434 @@
+// tiny3d_tests
+// Checks that the different paths through the tiny3d rendering functions agree with each other. Prints one line per test and exits with a non-zero status if any test fails.
+// Build from the repository root, e.g.
+//   g++ -O2 -std=c++11 -I. tests/tiny3d_tests.cpp tiny_*.cpp -pthread -o tiny3d_tests
+// Usage:
+//   tiny3d_tests [--filter text]
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "tiny3d.h"
+
+using namespace tiny3d;
+
+// @data Test
+// @info A named test. Returns TRUE on success, and prints the reason of a failure itself.
+struct Test
+{
+	const char *name;
+	bool      (*run)( void );
+};
+
+// @algo Random
+// @info A linear congruential generator, so that every run tests the same cases on every platform.
+// @inout seed -> The state of the generator.
+// @out A number in the range [0, 1).
+float Random(UInt &seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return float(seed >> 8) / float(1 << 24);
+}
+
+// @algo CountDifferences
+// @info Compares two images of the same dimensions pixel by pixel.
+// @in
+//   a, b -> The images.
+//   tolerance -> The largest difference per channel for which two pixels are considered equal.
+// @out The number of pixels that differ by more than the tolerance in any channel, or in blend mode.
+UInt CountDifferences(const Image &a, const Image &b, SInt tolerance)
+{
+	UInt n = 0;
+	for (UInt y = 0; y < a.GetHeight(); ++y) {
+		for (UInt x = 0; x < a.GetWidth(); ++x) {
+			const Color ca = a.GetColor(UPoint{ x, y });
+			const Color cb = b.GetColor(UPoint{ x, y });
+			if (Abs(SInt(ca.r) - SInt(cb.r)) > tolerance || Abs(SInt(ca.g) - SInt(cb.g)) > tolerance || Abs(SInt(ca.b) - SInt(cb.b)) > tolerance || ca.blend != cb.blend) { ++n; }
+		}
+	}
+	return n;
+}
+
+// @algo TestTiledLines
+// @info Lines recorded by a TileRenderer cross the seams between its tiles, and must cover exactly the pixels of the same lines drawn directly.
+bool TestTiledLines( void )
+{
+	const UInt W = 160, H = 120;
+	Image direct(W, H), tiled(W, H);
+	direct.Fill(Color{ 0, 0, 0, Color::Solid });
+	tiled.Fill(Color{ 0, 0, 0, Color::Solid });
+
+	TileRenderer tiles(1, 16);
+	UInt seed = 1;
+	for (UInt i = 0; i < 300; ++i) {
+		Vertex v[2];
+		for (UInt j = 0; j < 2; ++j) {
+			v[j].v = Vector3(Random(seed) * (W + 80) - 40, Random(seed) * (H + 80) - 40, 1.0f);
+			v[j].t = Vector2(0.0f, 0.0f);
+			v[j].c = Color{ Byte(Random(seed) * 256), Byte(Random(seed) * 256), Byte(Random(seed) * 256), Color::Solid };
+		}
+		DrawLine(direct, nullptr, nullptr, v[0], v[1], nullptr);
+		tiles.DrawLine(tiled, nullptr, nullptr, v[0], v[1], nullptr);
+	}
+	tiles.Flush();
+
+	const UInt diff = CountDifferences(direct, tiled, 0);
+	if (diff > 0) { std::printf("  %u pixels differ\n", diff); }
+	return diff == 0;
+}
+
+// @algo RenderSubdivision
+// @info Draws random vertex colored triangles spanning a wide range of depths, so that many blocks reach past the edges of a triangle where depth changes quickly.
+// @in perspective -> The perspective mode to draw with.
+// @inout
+//   dst -> The destination color buffer.
+//   zbuf -> The depth buffer.
+void RenderSubdivision(PerspectiveMode perspective, Image &dst, Array<float> &zbuf)
+{
+	dst.Fill(Color{ 0, 0, 0, Color::Solid });
+	for (UInt i = 0; i < zbuf.GetSize(); ++i) { zbuf[i] = std::numeric_limits<float>::infinity(); }
+
+	UInt seed = 7;
+	for (UInt i = 0; i < 200; ++i) {
+		Vertex v[3];
+		for (UInt j = 0; j < 3; ++j) {
+			v[j].v = Vector3(Random(seed) * dst.GetWidth(), Random(seed) * dst.GetHeight(), 1.0f + Random(seed) * 63.0f);
+			v[j].t = Vector2(0.0f, 0.0f);
+			v[j].c = Color{ Byte(Random(seed) * 256), Byte(Random(seed) * 256), Byte(Random(seed) * 256), Color::Solid };
+		}
+		DrawTriangle_Fast(dst, &zbuf, &zbuf, v[0], v[1], v[2], nullptr, nullptr, perspective, DepthFormat_Z, nullptr, CullMode_None);
+	}
+}
+
+// @algo TestSubdivision
+// @info Subdivided perspective modes only interpolate the perspective correct weights between exact divides at the corners of blocks, and must stay within two steps of the 5-bit color channels of PerspectiveMode_Correct everywhere. Depth is divided per pixel, and must match up to rounding. Tested on every supported SIMD level, since the levels rasterize in fragments of different sizes.
+bool TestSubdivision( void )
+{
+	const UInt W = 160, H = 120;
+	const SIMDLevel       levels[] = { SIMDLevel_None, SIMDLevel_SSE, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON, SIMDLevel_AltiVec };
+	const SIMDLevel       initial  = GetSIMDLevel();
+	const PerspectiveMode modes[]  = { PerspectiveMode_Subdivide8, PerspectiveMode_Subdivide16 };
+	bool ok = true;
+	for (SIMDLevel level : levels) {
+		if (!SetSIMDLevel(level)) { continue; }
+
+		Image        correct(W, H);
+		Array<float> correct_z(W * H);
+		RenderSubdivision(PerspectiveMode_Correct, correct, correct_z);
+
+		for (PerspectiveMode perspective : modes) {
+			Image        dst(W, H);
+			Array<float> zbuf(W * H);
+			RenderSubdivision(perspective, dst, zbuf);
+
+			const UInt diff  = CountDifferences(correct, dst, 16);
+			UInt       zdiff = 0;
+			for (UInt i = 0; i < W * H; ++i) {
+				if (Abs(zbuf[i] - correct_z[i]) > correct_z[i] * (1.0f / 4096.0f)) { ++zdiff; }
+			}
+			if (diff > 0 || zdiff > 0) {
+				std::printf("  %s subdivide%d: %u pixels differ in color, %u in depth\n", GetSIMDLevelName(level), perspective == PerspectiveMode_Subdivide8 ? 8 : 16, diff, zdiff);
+				ok = false;
+			}
+		}
+	}
+	SetSIMDLevel(initial);
+	return ok;
+}
+
+// @algo ClearDepth
+// @info Clears a depth buffer to the farthest depth of a depth format.
+// @in depth_format -> The depth format.
+// @inout zbuf -> The depth buffer.
+void ClearDepth(Array<float> &zbuf, DepthFormat depth_format)
+{
+	for (UInt i = 0; i < zbuf.GetSize(); ++i) { zbuf[i] = depth_format == DepthFormat_InvZ ? 0.0f : std::numeric_limits<float>::infinity(); }
+}
+
+void ClearDepth(Array<UHInt> &zbuf, DepthFormat depth_format)
+{
+	for (UInt i = 0; i < zbuf.GetSize(); ++i) { zbuf[i] = depth_format == DepthFormat_InvZ ? 0 : 0xffff; }
+}
+
+// @algo RenderOverlapping
+// @info Draws random overlapping triangles at random depths, so that many triangles and blocks are hidden behind earlier ones.
+// @in
+//   depth_format -> The depth format to draw with.
+//   hiz -> The coarse depth buffer to draw with. NULL draws without one.
+// @inout
+//   dst -> The destination color buffer.
+//   zbuf -> The depth buffer.
+template < typename depth_t >
+void RenderOverlapping(DepthFormat depth_format, HiZBuffer *hiz, Image &dst, Array<depth_t> &zbuf)
+{
+	dst.Fill(Color{ 0, 0, 0, Color::Solid });
+	ClearDepth(zbuf, depth_format);
+	if (hiz != nullptr) { hiz->Clear(depth_format); }
+
+	UInt seed = 5;
+	for (UInt i = 0; i < 400; ++i) {
+		const float x = Random(seed) * dst.GetWidth(), y = Random(seed) * dst.GetHeight(), r = 4.0f + Random(seed) * 80.0f, z = 1.0f + Random(seed) * 30.0f;
+		Vertex v[3];
+		for (UInt j = 0; j < 3; ++j) {
+			v[j].v = Vector3(x + (Random(seed) * 2.0f - 1.0f) * r, y + (Random(seed) * 2.0f - 1.0f) * r, z + Random(seed) * 4.0f);
+			v[j].t = Vector2(0.0f, 0.0f);
+			v[j].c = Color{ Byte(Random(seed) * 256), Byte(Random(seed) * 256), Byte(Random(seed) * 256), Color::Solid };
+		}
+		DrawTriangle_Fast(dst, &zbuf, &zbuf, v[0], v[1], v[2], nullptr, nullptr, PerspectiveMode_Correct, depth_format, hiz, CullMode_None);
+	}
+}
+
+// @algo CompareHiZ
+// @info Draws the same triangles with and without a coarse depth buffer. Rejecting triangles and blocks with the coarse depth buffer must never change a pixel.
+// @in depth_format -> The depth format to draw with.
+// @out The number of pixels that differ in color or depth.
+template < typename depth_t >
+UInt CompareHiZ(DepthFormat depth_format)
+{
+	const UInt W = 160, H = 120;
+	Image          plain(W, H), culled(W, H);
+	Array<depth_t> plain_z(W * H), culled_z(W * H);
+	HiZBuffer      hiz(W, H);
+	RenderOverlapping<depth_t>(depth_format, nullptr, plain, plain_z);
+	RenderOverlapping<depth_t>(depth_format, &hiz, culled, culled_z);
+
+	UInt diff = CountDifferences(plain, culled, 0);
+	for (UInt i = 0; i < W * H; ++i) {
+		if (plain_z[i] != culled_z[i]) { ++diff; }
+	}
+	return diff;
+}
+
+// @algo TestHiZ
+// @info The coarse depth buffer is a pure optimization, and must produce identical images and depth buffers for every depth format and depth buffer type. Tested on every supported SIMD level, since the levels reject blocks of different sizes.
+bool TestHiZ( void )
+{
+	const SIMDLevel levels[] = { SIMDLevel_None, SIMDLevel_SSE, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON, SIMDLevel_AltiVec };
+	const SIMDLevel initial  = GetSIMDLevel();
+	bool ok = true;
+	for (SIMDLevel level : levels) {
+		if (!SetSIMDLevel(level)) { continue; }
+
+		const UInt diff[3] = { CompareHiZ<float>(DepthFormat_Z), CompareHiZ<float>(DepthFormat_InvZ), CompareHiZ<UHInt>(DepthFormat_Z) };
+		if (diff[0] > 0 || diff[1] > 0 || diff[2] > 0) {
+			std::printf("  %s: %u pixels differ with Z, %u with InvZ, %u with 16-bit Z\n", GetSIMDLevelName(level), diff[0], diff[1], diff[2]);
+			ok = false;
+		}
+	}
+	SetSIMDLevel(initial);
+	return ok;
+}
+
+// @algo HasGaps
+// @info Compares the uncovered parts of a span with the expected ones.
+// @in
+//   spans -> The span buffer.
+//   y -> The scanline.
+//   span -> The span to test.
+//   expected, count -> The expected uncovered parts from left to right.
+// @out TRUE if the uncovered parts match.
+bool HasGaps(SpanBuffer &spans, UInt y, SpanBuffer::Span span, const SpanBuffer::Span *expected, UInt count)
+{
+	const UInt n = spans.GetUncovered(y, span);
+	bool ok = n == count;
+	for (UInt i = 0; ok && i < n; ++i) {
+		ok = spans.GetGap(i).a == expected[i].a && spans.GetGap(i).b == expected[i].b;
+	}
+	if (!ok) {
+		std::printf("  scanline %u:", y);
+		for (UInt i = 0; i < n; ++i) { std::printf(" [%u, %u)", spans.GetGap(i).a, spans.GetGap(i).b); }
+		std::printf("\n");
+	}
+	return ok;
+}
+
+// @algo TestSpanBuffer
+// @info Covered spans that touch or overlap must be merged into one, so that a scanline covered piece by piece reports itself as fully covered, and uncovered parts are reported exactly.
+bool TestSpanBuffer( void )
+{
+	const UInt W = 16;
+	SpanBuffer spans(W, 5);
+	bool ok = true;
+
+	// touching spans, covered out of order
+	spans.Cover(0, SpanBuffer::Span{ 8, 16 });
+	spans.Cover(0, SpanBuffer::Span{ 0, 4 });
+	ok = !spans.IsCovered(0) && ok;
+	spans.Cover(0, SpanBuffer::Span{ 4, 8 });
+	ok = spans.IsCovered(0) && ok;
+	ok = HasGaps(spans, 0, SpanBuffer::Span{ 0, W }, nullptr, 0) && ok;
+
+	// overlapping spans
+	const SpanBuffer::Span overlap[] = { { 0, 2 }, { 10, 16 } };
+	spans.Cover(1, SpanBuffer::Span{ 2, 6 });
+	spans.Cover(1, SpanBuffer::Span{ 4, 10 });
+	ok = HasGaps(spans, 1, SpanBuffer::Span{ 0, W }, overlap, 2) && ok;
+
+	// a span bridging several covered spans, and a test span starting inside a covered span
+	const SpanBuffer::Span bridge[] = { { 10, 14 } };
+	spans.Cover(2, SpanBuffer::Span{ 0, 2 });
+	spans.Cover(2, SpanBuffer::Span{ 4, 6 });
+	spans.Cover(2, SpanBuffer::Span{ 8, 10 });
+	spans.Cover(2, SpanBuffer::Span{ 1, 9 });
+	spans.Cover(2, SpanBuffer::Span{ 14, 16 });
+	ok = HasGaps(spans, 2, SpanBuffer::Span{ 5, 16 }, bridge, 1) && ok;
+
+	// separate spans, alternating pixels
+	const SpanBuffer::Span alternate[] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+	for (UInt x = 0; x < W; x += 2) { spans.Cover(3, SpanBuffer::Span{ x, x + 1 }); }
+	ok = HasGaps(spans, 3, SpanBuffer::Span{ 1, 6 }, alternate, 3) && ok;
+
+	// a full row cover, and an empty span
+	spans.Cover(4, SpanBuffer::Span{ 3, 3 });
+	ok = !spans.IsCovered(4) && ok;
+	spans.Cover(4, SpanBuffer::Span{ 0, W });
+	ok = spans.IsCovered(4) && ok;
+
+	// clearing uncovers everything
+	const SpanBuffer::Span full[] = { { 0, W } };
+	spans.Clear();
+	for (UInt y = 0; y < spans.GetHeight(); ++y) {
+		ok = !spans.IsCovered(y) && HasGaps(spans, y, SpanBuffer::Span{ 0, W }, full, 1) && ok;
+	}
+	if (!ok) { std::printf("  spans were not merged as expected\n"); }
+	return ok;
+}
+
+// @algo RenderNearlyConstantDepth
+// @info Draws floors and walls whose depth changes by less than 1/1000 along rows or columns, but by more than float rounding.
+// @in
+//   fast -> TRUE to draw with DrawTriangle_Fast, FALSE to draw with DrawTriangle.
+//   perspective -> The perspective mode DrawTriangle_Fast draws with.
+// @inout
+//   dst -> The destination color buffer.
+//   zbuf -> The depth buffer.
+template < typename depth_t >
+void RenderNearlyConstantDepth(bool fast, PerspectiveMode perspective, Image &dst, Array<depth_t> &zbuf)
+{
+	dst.Fill(Color{ 0, 0, 0, Color::Solid });
+	ClearDepth(zbuf, DepthFormat_Z);
+
+	UInt seed = 3;
+	for (UInt i = 0; i < 100; ++i) {
+		const bool  wall  = (i & 1) != 0;
+		const float z     = 1.0f + Random(seed) * 30.0f;
+		const float slope = z * (Random(seed) - 0.5f) * (1.0f / 120000.0f); // change of depth per pixel along the constant axis
+		const float ramp  = z * (Random(seed) - 0.5f) * (1.0f / 100.0f);    // change of depth per pixel across it
+		Vertex v[3];
+		for (UInt j = 0; j < 3; ++j) {
+			const float x = Random(seed) * dst.GetWidth(), y = Random(seed) * dst.GetHeight();
+			v[j].v = Vector3(x, y, z + (wall ? y * slope + x * ramp : x * slope + y * ramp));
+			v[j].t = Vector2(0.0f, 0.0f);
+			v[j].c = Color{ Byte(Random(seed) * 256), Byte(Random(seed) * 256), Byte(Random(seed) * 256), Color::Solid };
+		}
+		if (fast) { DrawTriangle_Fast(dst, &zbuf, &zbuf, v[0], v[1], v[2], nullptr, nullptr, perspective, DepthFormat_Z, nullptr, CullMode_None); }
+		else      { DrawTriangle(dst, &zbuf, &zbuf, v[0], v[1], v[2], nullptr, nullptr, DepthFormat_Z, CullMode_None); }
+	}
+}
+
+// @algo TestConstantDepth
+// @info Triangles of nearly constant depth along rows or columns are drawn one line at a time with one perspective divide per line. Depth must still be computed per pixel, and match DrawTriangle up to the rounding of interpolation, or one step of a 16-bit depth buffer, in every perspective mode. Tested on every supported SIMD level.
+bool TestConstantDepth( void )
+{
+	const UInt W = 160, H = 120;
+	const SIMDLevel       levels[] = { SIMDLevel_None, SIMDLevel_SSE, SIMDLevel_AVX2, SIMDLevel_AVX512, SIMDLevel_NEON, SIMDLevel_AltiVec };
+	const SIMDLevel       initial  = GetSIMDLevel();
+	const PerspectiveMode modes[]  = { PerspectiveMode_Correct, PerspectiveMode_Subdivide8, PerspectiveMode_Subdivide16 };
+
+	Image        ref(W, H), dst(W, H);
+	Array<float> ref_z(W * H), zbuf(W * H);
+	Array<UHInt> ref_z16(W * H), zbuf16(W * H);
+	RenderNearlyConstantDepth(false, PerspectiveMode_Correct, ref, ref_z);
+	RenderNearlyConstantDepth(false, PerspectiveMode_Correct, ref, ref_z16);
+
+	bool ok = true;
+	for (SIMDLevel level : levels) {
+		if (!SetSIMDLevel(level)) { continue; }
+		for (PerspectiveMode perspective : modes) {
+			RenderNearlyConstantDepth(true, perspective, dst, zbuf);
+			RenderNearlyConstantDepth(true, perspective, dst, zbuf16);
+			UInt zdiff = 0, zdiff16 = 0;
+			for (UInt i = 0; i < W * H; ++i) {
+				if (Abs(zbuf[i] - ref_z[i]) > ref_z[i] * (1.0f / 32768.0f)) { ++zdiff; }
+				if (Abs(SInt(zbuf16[i]) - SInt(ref_z16[i])) > 1)             { ++zdiff16; }
+			}
+			if (zdiff > 0 || zdiff16 > 0) {
+				std::printf("  %s perspective mode %d: %u pixels differ in depth, %u in 16-bit depth\n", GetSIMDLevelName(level), SInt(perspective), zdiff, zdiff16);
+				ok = false;
+			}
+		}
+	}
+	SetSIMDLevel(initial);
+	return ok;
+}
+
+// @algo TestClipping
+// @info Triangles that cross the near plane or reach far past the guard band must be clipped to projected triangles in front of the viewer, whose screen coordinates fit inside the guard band. An empty viewport must project nothing.
+bool TestClipping( void )
+{
+	const URect     viewport   = { UPoint{ 0, 0 }, UPoint{ 160, 120 } };
+	const URect     empty      = { UPoint{ 0, 0 }, UPoint{ 0, 120 } };
+	const Matrix4x4 projection = Perspective(Real(1.2f), Real(160.0f / 120.0f), Real(0.5f), Real(100.0f));
+	const float     GUARD_BAND = 8192.0f;
+	bool ok = true;
+
+	UInt seed = 11, clipped = 0;
+	for (UInt i = 0; i < 2000; ++i) {
+		Vertex v[3];
+		for (UInt j = 0; j < 3; ++j) {
+			v[j].v = Vector3(Random(seed) * 400.0f - 200.0f, Random(seed) * 400.0f - 200.0f, Random(seed) * 60.0f - 10.0f);
+			v[j].t = Vector2(0.0f, 0.0f);
+			v[j].c = Color{ 255, 255, 255, Color::Solid };
+		}
+		Vertex     out[3 * MaxClippedTriangles()];
+		const UInt n = ProjectTriangle(projection, v[0], v[1], v[2], viewport, out, true);
+		if (n > 1) { ++clipped; }
+		for (UInt j = 0; j < n * 3; ++j) {
+			if (!(float(out[j].v.z) > 0.0f) || !(Abs(float(out[j].v.x)) <= GUARD_BAND) || !(Abs(float(out[j].v.y)) <= GUARD_BAND)) {
+				std::printf("  triangle %u projects a vertex to (%g, %g, w=%g)\n", i, float(out[j].v.x), float(out[j].v.y), float(out[j].v.z));
+				ok = false;
+				break;
+			}
+		}
+		if (ProjectTriangle(projection, v[0], v[1], v[2], empty, out, true) != 0) {
+			std::printf("  triangle %u is projected to an empty viewport\n", i);
+			ok = false;
+		}
+	}
+	if (clipped == 0) {
+		std::printf("  no triangle was clipped\n");
+		ok = false;
+	}
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filter = argv[++i];
+		} else {
+			std::fprintf(stderr, "usage: %s [--filter text]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	static const Test TESTS[] = {
+		{ "tiled_lines", TestTiledLines },
+		{ "subdivision", TestSubdivision },
+		{ "hiz",         TestHiZ },
+		{ "span_buffer", TestSpanBuffer },
+		{ "const_depth", TestConstantDepth },
+		{ "clipping",    TestClipping }
+	};
+
+	UInt failed = 0;
+	for (const Test &test : TESTS) {
+		if (filter != nullptr && std::strstr(test.name, filter) == nullptr) { continue; }
+		const bool ok = test.run();
+		std::printf("%s %s\n", ok ? "PASS" : "FAIL", test.name);
+		if (!ok) { ++failed; }
+	}
+	return failed > 0 ? 1 : 0;
+}
@@ -1,11 +1,18 @@
 #ifndef TINY3D_H
 #define TINY3D_H
 
+#include "tiny_command.h"
+#include "tiny_cpu.h"
 #include "tiny_draw.h"
+#include "tiny_hiz.h"
 #include "tiny_image.h"
 #include "tiny_math.h"
+#include "tiny_span.h"
+#include "tiny_stats.h"
 #include "tiny_structs.h"
 #include "tiny_system.h"
 #include "tiny_texture.h"
+#include "tiny_tile.h"
+#include "tiny_transform.h"
 
 #endif // TINY3D_H
@@ -0,0 +1,302 @@
+#include <cstring>
+#include "tiny_command.h"
+#include "tiny_draw.h"
+
+using namespace tiny3d;
+
+tiny3d::Byte *tiny3d::CommandBuffer::Append(size_t size)
+{
+	const UInt offset = m_size;
+	if (offset + size > m_buffer.GetSize()) {
+		m_buffer.Resize(tiny3d::Max(UInt(offset + size), m_buffer.GetSize() * 2));
+	}
+	m_size += UInt(size);
+	return static_cast<Byte*>(m_buffer) + offset;
+}
+
+template < typename type_t >
+void tiny3d::CommandBuffer::Write(const type_t &data)
+{
+	std::memcpy(Append(sizeof(type_t)), &data, sizeof(type_t));
+}
+
+template < typename type_t >
+type_t tiny3d::CommandBuffer::Read(const tiny3d::Byte *&data)
+{
+	type_t out;
+	std::memcpy(&out, data, sizeof(type_t));
+	data += sizeof(type_t);
+	return out;
+}
+
+void tiny3d::CommandBuffer::SetDirty( void )
+{
+	m_dirty = true;
+	m_batch = m_size;
+}
+
+void tiny3d::CommandBuffer::Begin(Op op)
+{
+	if (m_batch < m_size) {
+		const Byte   *data   = static_cast<Byte*>(m_buffer) + m_batch;
+		const Header  header = Read<Header>(data);
+		if (header.op == UInt(op)) { return; }
+	}
+	if (m_dirty) {
+		Write(Header{ UInt(Op_State), 0 });
+		Write(m_state);
+		m_dirty = false;
+	}
+	m_batch = m_size;
+	Write(Header{ UInt(op), 0 });
+}
+
+template < typename vert_t >
+void tiny3d::CommandBuffer::Push(Op op, const vert_t *verts, tiny3d::UInt count)
+{
+	if (m_state.dst == nullptr) { return; }
+	Begin(op);
+	std::memcpy(Append(sizeof(vert_t) * count), verts, sizeof(vert_t) * count);
+	Header header;
+	std::memcpy(&header, static_cast<Byte*>(m_buffer) + m_batch, sizeof(Header));
+	++header.count;
+	std::memcpy(static_cast<Byte*>(m_buffer) + m_batch, &header, sizeof(Header));
+}
+
+template < typename depth_t >
+void tiny3d::CommandBuffer::Submit(const State &state, const Header &batch, const tiny3d::Byte *verts, tiny3d::TileRenderer *tiles, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite) const
+{
+	// NOTE: The mask rectangle is clipped against the destination once per batch so that batches masked out entirely are skipped. Each draw call still clips its primitive against the rectangle.
+	const URect  srect    = URect{ { 0, 0 }, { state.dst->GetWidth(), state.dst->GetHeight() } };
+	const URect  rect     = state.has_rect ? tiny3d::Clip(state.rect, srect) : srect;
+	const URect *dst_rect = &rect;
+	if (rect.a.x >= rect.b.x || rect.a.y >= rect.b.y) { return; }
+
+	switch (batch.op) {
+	case Op_Lines:
+		for (UInt i = 0; i < batch.count; ++i) {
+			const Vertex a = Read<Vertex>(verts);
+			const Vertex b = Read<Vertex>(verts);
+			if (tiles != nullptr) { tiles->DrawLine(*state.dst, zread, zwrite, a, b, state.tex, dst_rect, state.depth_format); }
+			else                  { tiny3d::DrawLine(*state.dst, zread, zwrite, a, b, state.tex, dst_rect, state.depth_format); }
+		}
+		break;
+	case Op_Triangles:
+	case Op_Triangles_Fast:
+		for (UInt i = 0; i < batch.count; ++i) {
+			const Vertex a = Read<Vertex>(verts);
+			const Vertex b = Read<Vertex>(verts);
+			const Vertex c = Read<Vertex>(verts);
+			if (batch.op == Op_Triangles) {
+				if (tiles != nullptr) { tiles->DrawTriangle(*state.dst, zread, zwrite, a, b, c, state.tex, dst_rect, state.depth_format, state.cull_mode); }
+				else                  { tiny3d::DrawTriangle(*state.dst, zread, zwrite, a, b, c, state.tex, dst_rect, state.depth_format, state.cull_mode); }
+			} else {
+				if (tiles != nullptr) { tiles->DrawTriangle_Fast(*state.dst, zread, zwrite, a, b, c, state.tex, dst_rect, state.perspective, state.depth_format, state.hiz, state.cull_mode); }
+				else                  { tiny3d::DrawTriangle_Fast(*state.dst, zread, zwrite, a, b, c, state.tex, dst_rect, state.perspective, state.depth_format, state.hiz, state.cull_mode); }
+			}
+		}
+		break;
+	case Op_LTriangles:
+	case Op_LTriangles_Fast:
+		for (UInt i = 0; i < batch.count; ++i) {
+			const LVertex a = Read<LVertex>(verts);
+			const LVertex b = Read<LVertex>(verts);
+			const LVertex c = Read<LVertex>(verts);
+			if (batch.op == Op_LTriangles) {
+				if (tiles != nullptr) { tiles->DrawTriangle(*state.dst, zread, zwrite, a, b, c, state.tex, *state.lightmap, dst_rect, state.depth_format, state.cull_mode); }
+				else                  { tiny3d::DrawTriangle(*state.dst, zread, zwrite, a, b, c, state.tex, *state.lightmap, dst_rect, state.depth_format, state.cull_mode); }
+			} else {
+				if (tiles != nullptr) { tiles->DrawTriangle_Fast(*state.dst, zread, zwrite, a, b, c, state.tex, *state.lightmap, dst_rect, state.perspective, state.depth_format, state.hiz, state.cull_mode); }
+				else                  { tiny3d::DrawTriangle_Fast(*state.dst, zread, zwrite, a, b, c, state.tex, *state.lightmap, dst_rect, state.perspective, state.depth_format, state.hiz, state.cull_mode); }
+			}
+		}
+		break;
+	}
+}
+
+void tiny3d::CommandBuffer::Flush(tiny3d::TileRenderer *tiles)
+{
+	State        state = m_state;
+	const Byte  *data  = static_cast<Byte*>(m_buffer);
+	const Byte  *end   = data + m_size;
+	while (data < end) {
+		const Header batch = Read<Header>(data);
+		if (batch.op == Op_State) {
+			state = Read<State>(data);
+			continue;
+		}
+		if (state.zread16 != nullptr || state.zwrite16 != nullptr) {
+			Submit(state, batch, data, tiles, state.zread16, state.zwrite16);
+		} else {
+			Submit(state, batch, data, tiles, state.zread, state.zwrite);
+		}
+		switch (batch.op) {
+		case Op_Lines: data += sizeof(Vertex) * 2 * batch.count; break;
+		case Op_Triangles:
+		case Op_Triangles_Fast: data += sizeof(Vertex) * 3 * batch.count; break;
+		default: data += sizeof(LVertex) * 3 * batch.count; break;
+		}
+	}
+	if (tiles != nullptr) {
+		tiles->Flush();
+	}
+	Clear();
+}
+
+tiny3d::CommandBuffer::CommandBuffer( void ) : m_buffer(), m_size(0), m_state(), m_batch(0), m_dirty(true)
+{
+	m_state.dst          = nullptr;
+	m_state.zread        = nullptr;
+	m_state.zwrite       = nullptr;
+	m_state.zread16      = nullptr;
+	m_state.zwrite16     = nullptr;
+	m_state.tex          = nullptr;
+	m_state.lightmap     = nullptr;
+	m_state.rect         = URect{ { 0, 0 }, { 0, 0 } };
+	m_state.has_rect     = false;
+	m_state.perspective  = PerspectiveMode_Correct;
+	m_state.depth_format = DepthFormat_Z;
+	m_state.hiz          = nullptr;
+	m_state.cull_mode    = CullMode_CCW;
+}
+
+void tiny3d::CommandBuffer::SetTarget(tiny3d::Image *dst)
+{
+	if (m_state.dst != dst) {
+		m_state.dst = dst;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetDepthBuffers(const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, tiny3d::DepthFormat depth_format)
+{
+	if (m_state.zread != zread || m_state.zwrite != zwrite || m_state.zread16 != nullptr || m_state.zwrite16 != nullptr || m_state.depth_format != depth_format) {
+		m_state.zread        = zread;
+		m_state.zwrite       = zwrite;
+		m_state.zread16      = nullptr;
+		m_state.zwrite16     = nullptr;
+		m_state.depth_format = depth_format;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetDepthBuffers(const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, tiny3d::DepthFormat depth_format)
+{
+	if (m_state.zread != nullptr || m_state.zwrite != nullptr || m_state.zread16 != zread || m_state.zwrite16 != zwrite || m_state.depth_format != depth_format) {
+		m_state.zread        = nullptr;
+		m_state.zwrite       = nullptr;
+		m_state.zread16      = zread;
+		m_state.zwrite16     = zwrite;
+		m_state.depth_format = depth_format;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetDepthBuffers(std::nullptr_t, std::nullptr_t, tiny3d::DepthFormat depth_format)
+{
+	SetDepthBuffers(static_cast<const Array<float>*>(nullptr), static_cast<Array<float>*>(nullptr), depth_format);
+}
+
+void tiny3d::CommandBuffer::SetTexture(const tiny3d::Texture *tex)
+{
+	if (m_state.tex != tex) {
+		m_state.tex = tex;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetLightmap(const tiny3d::Texture *lightmap)
+{
+	if (m_state.lightmap != lightmap) {
+		m_state.lightmap = lightmap;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetRect(const tiny3d::URect *dst_rect)
+{
+	const bool  has_rect = (dst_rect != nullptr);
+	const URect rect     = has_rect ? *dst_rect : URect{ { 0, 0 }, { 0, 0 } };
+	if (m_state.has_rect != has_rect || m_state.rect.a.x != rect.a.x || m_state.rect.a.y != rect.a.y || m_state.rect.b.x != rect.b.x || m_state.rect.b.y != rect.b.y) {
+		m_state.has_rect = has_rect;
+		m_state.rect     = rect;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetPerspective(tiny3d::PerspectiveMode perspective)
+{
+	if (m_state.perspective != perspective) {
+		m_state.perspective = perspective;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetHiZBuffer(tiny3d::HiZBuffer *hiz)
+{
+	if (m_state.hiz != hiz) {
+		m_state.hiz = hiz;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::SetCullMode(tiny3d::CullMode cull_mode)
+{
+	if (m_state.cull_mode != cull_mode) {
+		m_state.cull_mode = cull_mode;
+		SetDirty();
+	}
+}
+
+void tiny3d::CommandBuffer::DrawLine(const tiny3d::Vertex &a, const tiny3d::Vertex &b)
+{
+	const Vertex v[2] = { a, b };
+	Push(Op_Lines, v, 2);
+}
+
+void tiny3d::CommandBuffer::DrawTriangle(const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c)
+{
+	const Vertex v[3] = { a, b, c };
+	Push(Op_Triangles, v, 3);
+}
+
+void tiny3d::CommandBuffer::DrawTriangle_Fast(const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c)
+{
+	const Vertex v[3] = { a, b, c };
+	Push(Op_Triangles_Fast, v, 3);
+}
+
+void tiny3d::CommandBuffer::DrawTriangle(const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c)
+{
+	if (m_state.lightmap == nullptr) { return; }
+	const LVertex v[3] = { a, b, c };
+	Push(Op_LTriangles, v, 3);
+}
+
+void tiny3d::CommandBuffer::DrawTriangle_Fast(const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c)
+{
+	if (m_state.lightmap == nullptr) { return; }
+	const LVertex v[3] = { a, b, c };
+	Push(Op_LTriangles_Fast, v, 3);
+}
+
+void tiny3d::CommandBuffer::Flush( void )
+{
+	Flush(nullptr);
+}
+
+void tiny3d::CommandBuffer::Flush(tiny3d::TileRenderer &tiles)
+{
+	Flush(&tiles);
+}
+
+void tiny3d::CommandBuffer::Clear( void )
+{
+	m_size = 0;
+	SetDirty();
+}
+
+tiny3d::UInt tiny3d::CommandBuffer::GetSize( void ) const
+{
+	return UInt(m_size);
+}
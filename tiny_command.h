@@ -0,0 +1,160 @@
+#ifndef TINY_COMMAND_H
+#define TINY_COMMAND_H
+
+#include "tiny_system.h"
+#include "tiny_math.h"
+#include "tiny_image.h"
+#include "tiny_texture.h"
+#include "tiny_structs.h"
+#include "tiny_hiz.h"
+#include "tiny_tile.h"
+
+namespace tiny3d
+{
+
+// @data CommandBuffer
+// @info A buffered state machine front end to the rendering functions. Render targets, depth buffers, textures and the mask rectangle are bound as state, and draw calls are recorded into a linear buffer that is submitted in one go by Flush. Consecutive draw calls sharing the same state are stored as one batch. Batches are submitted in the order they were recorded and never sorted by state, since that would change the result of blending and of fragments with equal depth.
+// @note Bound objects are referenced, not copied, and must stay valid until the commands using them have been flushed.
+class CommandBuffer
+{
+private:
+	enum Op
+	{
+		Op_State,
+		Op_Lines,
+		Op_Triangles,
+		Op_Triangles_Fast,
+		Op_LTriangles,
+		Op_LTriangles_Fast
+	};
+
+	struct State
+	{
+		tiny3d::Image                      *dst;
+		const tiny3d::Array<float>         *zread;
+		tiny3d::Array<float>               *zwrite;
+		const tiny3d::Array<tiny3d::UHInt> *zread16;
+		tiny3d::Array<tiny3d::UHInt>       *zwrite16;
+		const tiny3d::Texture              *tex;
+		const tiny3d::Texture              *lightmap;
+		tiny3d::URect                       rect;
+		bool                                has_rect;
+		tiny3d::PerspectiveMode             perspective;
+		tiny3d::DepthFormat                 depth_format;
+		tiny3d::HiZBuffer                  *hiz;
+		tiny3d::CullMode                    cull_mode;
+	};
+
+	struct Header
+	{
+		tiny3d::UInt op;
+		tiny3d::UInt count; // number of primitives in a batch
+	};
+
+private:
+	tiny3d::Array<tiny3d::Byte> m_buffer; // grows geometrically and is kept between flushes
+	tiny3d::UInt                m_size;   // number of bytes recorded
+	State                       m_state;
+	size_t                      m_batch;  // offset of the open batch, or the buffer size if there is none
+	bool                        m_dirty;
+
+private:
+	tiny3d::Byte  *Append(size_t size);
+	template < typename type_t >
+	void           Write(const type_t &data);
+	template < typename type_t >
+	static type_t  Read(const tiny3d::Byte *&data);
+	void           SetDirty( void );
+	void           Begin(Op op);
+	template < typename vert_t >
+	void           Push(Op op, const vert_t *verts, tiny3d::UInt count);
+	template < typename depth_t >
+	void           Submit(const State &state, const Header &batch, const tiny3d::Byte *verts, tiny3d::TileRenderer *tiles, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite) const;
+	void           Flush(tiny3d::TileRenderer *tiles);
+
+public:
+	CommandBuffer( void );
+
+	// @algo SetTarget
+	// @info Binds the destination color buffer.
+	// @in dst -> The destination color buffer. NULL to discard draw calls.
+	void SetTarget(tiny3d::Image *dst);
+
+	// @algo SetDepthBuffers
+	// @info Binds the depth buffers. Binding 16-bit depth buffers unbinds 32-bit ones and vice versa.
+	// @in
+	//   zread -> The depth buffer used to determine visibility. NULL to disable depth read.
+	//   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
+	//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
+	void SetDepthBuffers(const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+	void SetDepthBuffers(const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+	void SetDepthBuffers(std::nullptr_t, std::nullptr_t, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+
+	// @algo SetTexture
+	// @info Binds the texture.
+	// @in tex -> The texture to use for rendering. NULL for untextured.
+	void SetTexture(const tiny3d::Texture *tex);
+
+	// @algo SetLightmap
+	// @info Binds the light map used by lightmap shaded triangles.
+	// @in lightmap -> The light map. NULL to discard lightmap shaded triangles.
+	void SetLightmap(const tiny3d::Texture *lightmap);
+
+	// @algo SetRect
+	// @info Binds the mask rectangle.
+	// @in dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+	void SetRect(const tiny3d::URect *dst_rect);
+
+	// @algo SetPerspective
+	// @info Sets the perspective mode used by DrawTriangle_Fast. See tiny3d::DrawTriangle_Fast.
+	// @in perspective -> The perspective mode.
+	void SetPerspective(tiny3d::PerspectiveMode perspective);
+
+	// @algo SetHiZBuffer
+	// @info Binds the coarse depth buffer used by DrawTriangle_Fast. See tiny3d::HiZBuffer.
+	// @in hiz -> The coarse depth buffer of the bound depth read buffer. NULL to disable.
+	void SetHiZBuffer(tiny3d::HiZBuffer *hiz);
+
+	// @algo SetCullMode
+	// @info Sets which triangles are discarded by the order of their vertices on screen. Defaults to tiny3d::CullMode_CCW. See tiny3d::CullMode.
+	// @in cull_mode -> The cull mode.
+	void SetCullMode(tiny3d::CullMode cull_mode);
+
+	// @algo DrawLine
+	// @info Records a line using the bound state. See tiny3d::DrawLine.
+	// @in a, b -> The vertices defining the line segment to render.
+	void DrawLine(const tiny3d::Vertex &a, const tiny3d::Vertex &b);
+
+	// @algo DrawTriangle
+	// @info Records a triangle using the bound state. See tiny3d::DrawTriangle.
+	// @in a, b, c -> The vertices defining the triangle to render.
+	void DrawTriangle(const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c);
+	void DrawTriangle_Fast(const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c);
+
+	// @algo DrawTriangle
+	// @info Records a lightmap shaded triangle using the bound state and light map. See tiny3d::DrawTriangle.
+	// @in a, b, c -> The vertices defining the triangle to render.
+	void DrawTriangle(const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c);
+	void DrawTriangle_Fast(const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c);
+
+	// @algo Flush
+	// @info Renders all recorded commands in order and clears the buffer. Bound state is kept.
+	void Flush( void );
+
+	// @algo Flush
+	// @info Submits all recorded commands to a tile renderer, flushes it and clears the buffer. Bound state is kept.
+	// @inout tiles -> The tile renderer used to render the commands.
+	void Flush(tiny3d::TileRenderer &tiles);
+
+	// @algo Clear
+	// @info Discards all recorded commands without rendering them. Bound state is kept.
+	void Clear( void );
+
+	// @algo GetSize
+	// @out The size in bytes of the recorded commands.
+	tiny3d::UInt GetSize( void ) const;
+};
+
+}
+
+#endif // TINY_COMMAND_H
@@ -0,0 +1,107 @@
+#include <cstdlib>
+#include <cstring>
+#include "tiny_cpu.h"
+
+#if TINY_SIMD_DISPATCH && TINY_COMPILER == TINY_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+using namespace tiny3d;
+
+#if TINY_SIMD_DISPATCH
+// @algo IsSupportedByCPU
+// @info Tests if the CPU, and the operating system, support the instructions of a SIMD backend compiled for runtime dispatch.
+// @in level -> The SIMD level.
+// @out TRUE if the backend can run.
+bool IsSupportedByCPU(tiny3d::SIMDLevel level)
+{
+#if TINY_COMPILER == TINY_COMPILER_MSVC
+	int info[4];
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	const unsigned long long xcr0 = (info[2] & (1 << 27)) != 0 ? _xgetbv(0) : 0; // OSXSAVE
+	const bool avx_state    = (info[2] & (1 << 28)) != 0 && (xcr0 & 0x06) == 0x06; // AVX, and the OS saves XMM and YMM registers
+	const bool avx512_state = avx_state && (xcr0 & 0xE0) == 0xE0;                  // the OS saves the AVX-512 registers
+	int ebx7 = 0;
+	if (max_leaf >= 7) {
+		__cpuidex(info, 7, 0);
+		ebx7 = info[1];
+	}
+	switch (level) {
+	case SIMDLevel_SSE:    return true; // part of x86-64
+	case SIMDLevel_AVX2:   return avx_state && (ebx7 & (1 << 5)) != 0;
+	case SIMDLevel_AVX512: return avx512_state && (ebx7 & (1 << 16)) != 0;
+	default:               return false;
+	}
+#else
+	// the builtins also check that the OS saves the registers
+	__builtin_cpu_init();
+	switch (level) {
+	case SIMDLevel_SSE:    return true; // part of x86-64
+	case SIMDLevel_AVX2:   return __builtin_cpu_supports("avx2");
+	case SIMDLevel_AVX512: return __builtin_cpu_supports("avx512f");
+	default:               return false;
+	}
+#endif
+}
+#endif
+
+// @algo InitialSIMDLevel
+// @info Selects the SIMD level at startup.
+// @out The SIMD level named by the TINY3D_SIMD environment variable if it is supported, otherwise the best supported SIMD level.
+tiny3d::SIMDLevel InitialSIMDLevel( void )
+{
+	static constexpr SIMDLevel LEVELS[] = { SIMDLevel_AVX512, SIMDLevel_AVX2, SIMDLevel_SSE, SIMDLevel_NEON, SIMDLevel_AltiVec, SIMDLevel_None };
+	const char *name = std::getenv("TINY3D_SIMD");
+	if (name != nullptr) {
+		for (SIMDLevel level : LEVELS) {
+			if (std::strcmp(name, GetSIMDLevelName(level)) == 0 && IsSIMDLevelSupported(level)) { return level; }
+		}
+	}
+	for (SIMDLevel level : LEVELS) {
+		if (IsSIMDLevelSupported(level)) { return level; }
+	}
+	return SIMDLevel(TINY_SIMD);
+}
+
+// @algo ActiveSIMDLevel
+// @out The SIMD level in use, selected the first time it is accessed.
+tiny3d::SIMDLevel &ActiveSIMDLevel( void )
+{
+	static SIMDLevel level = InitialSIMDLevel();
+	return level;
+}
+
+bool tiny3d::IsSIMDLevelSupported(tiny3d::SIMDLevel level)
+{
+#if TINY_SIMD_DISPATCH
+	return (level == SIMDLevel_SSE || level == SIMDLevel_AVX2 || level == SIMDLevel_AVX512) && IsSupportedByCPU(level);
+#else
+	return level == SIMDLevel(TINY_SIMD);
+#endif
+}
+
+tiny3d::SIMDLevel tiny3d::GetSIMDLevel( void )
+{
+	return ActiveSIMDLevel();
+}
+
+bool tiny3d::SetSIMDLevel(tiny3d::SIMDLevel level)
+{
+	if (!IsSIMDLevelSupported(level)) { return false; }
+	ActiveSIMDLevel() = level;
+	return true;
+}
+
+const char *tiny3d::GetSIMDLevelName(tiny3d::SIMDLevel level)
+{
+	switch (level) {
+	case SIMDLevel_SSE:     return "sse";
+	case SIMDLevel_AVX2:    return "avx2";
+	case SIMDLevel_AVX512:  return "avx512";
+	case SIMDLevel_NEON:    return "neon";
+	case SIMDLevel_AltiVec: return "altivec";
+	default:                return "none";
+	}
+}
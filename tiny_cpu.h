@@ -0,0 +1,46 @@
+#ifndef TINY_CPU_H
+#define TINY_CPU_H
+
+#include "tiny_system.h"
+#include "tiny_simd.h"
+
+namespace tiny3d
+{
+
+// @data SIMDLevel
+// @info Contains all possible values for the instruction set used by the _Fast functions. The values match TINY_SIMD.
+// @note On x86-64 the _Fast functions are compiled for SSE, AVX2 and AVX-512, and the best level supported by the CPU is selected at startup. The environment variable TINY3D_SIMD (sse, avx2 or avx512) selects another supported level instead, e.g. for benchmarking. Elsewhere, or when TINY_SIMD_NO_DISPATCH is defined, the only available level is the one enabled by the compiler options.
+enum SIMDLevel
+{
+	SIMDLevel_None    = TINY_SIMD_NONE,    // scalar, one pixel at a time
+	SIMDLevel_SSE     = TINY_SIMD_SSE,     // groups of 2x2 pixels
+	SIMDLevel_AVX2    = TINY_SIMD_AVX256,  // groups of 4x2 pixels
+	SIMDLevel_AVX512  = TINY_SIMD_AVX512,  // groups of 4x4 pixels
+	SIMDLevel_NEON    = TINY_SIMD_NEON,    // groups of 2x2 pixels
+	SIMDLevel_AltiVec = TINY_SIMD_ALTIVEC  // groups of 2x2 pixels
+};
+
+// @algo IsSIMDLevelSupported
+// @in level -> The SIMD level.
+// @out TRUE if the _Fast functions are compiled for the level and the CPU supports it.
+bool IsSIMDLevelSupported(tiny3d::SIMDLevel level);
+
+// @algo GetSIMDLevel
+// @out The SIMD level used by the _Fast functions.
+tiny3d::SIMDLevel GetSIMDLevel( void );
+
+// @algo SetSIMDLevel
+// @info Changes the SIMD level used by the _Fast functions.
+// @note Must not be called while other threads are drawing.
+// @in level -> The SIMD level.
+// @out TRUE on success. Levels that are not supported leave the SIMD level unchanged.
+bool SetSIMDLevel(tiny3d::SIMDLevel level);
+
+// @algo GetSIMDLevelName
+// @in level -> The SIMD level.
+// @out The name of the level, as accepted by the TINY3D_SIMD environment variable.
+const char *GetSIMDLevelName(tiny3d::SIMDLevel level);
+
+}
+
+#endif // TINY_CPU_H
@@ -2,36 +2,27 @@
 #include "tiny_math.h"
 #include "tiny_simd.h"
 #include "tiny_overlay.h"
+#include "tiny_cpu.h"
+#include "tiny_raster.h"
 
 using namespace tiny3d;
 
 namespace internal_impl
 {
-	struct IVertex
-	{
-		Point p;
-		float u, v;    // 1/tcoord (non-normalized)
-		float r, g, b; // 1/color
-		float w;       // 1/z
-	};
-
-	IVertex operator+(IVertex a, IVertex b) { return IVertex{ { a.p.x + b.p.x, a.p.y + b.p.y }, a.u + b.u, a.v + b.v, a.r + b.r, a.g + b.g, a.b + b.b, a.w + b.w }; }
-	IVertex operator-(IVertex a, IVertex b) { return IVertex{ { a.p.x - b.p.x, a.p.y - b.p.y }, a.u - b.u, a.v - b.v, a.r - b.r, a.g - b.g, a.b - b.b, a.w - b.w }; }
-	IVertex operator*(IVertex a, Real b)    { return IVertex{ { SInt(a.p.x * b), SInt(a.p.y * b) }, a.u * b, a.v * b, a.r * b, a.g * b, a.b * b, a.w * b }; }
-
-	struct ILVertex
-	{
-		Point p;
-		float u, v;   // 1/tcoord (non-normalized)
-		float lu, lv; // 1/lcoord (non-normalized)
-		float w;      // 1/z
-	};
-
-	void DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, internal_impl::IVertex a, internal_impl::IVertex b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect);
-	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect);
-	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect);
-	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect);
-	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect);
+	template < typename depth_t >
+	void DrawPoint(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format);
+	template < typename depth_t >
+	void DrawLine(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, internal_impl::IVertex a, internal_impl::IVertex b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format);
+	template < typename depth_t >
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode);
+	template < typename depth_t >
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode);
+	template < typename depth_t >
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode);
+	template < typename depth_t >
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode);
+	template < bool fast, typename depth_t, typename vert_t, typename index_t >
+	void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t *verts, tiny3d::UInt nverts, const index_t *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode);
 	template < typename src_t >
 	void DrawRegion(tiny3d::Image &dst, tiny3d::Rect dst_region, const src_t &src, tiny3d::Rect src_region, const tiny3d::URect *dst_rect);
 	tiny3d::Point DrawChars(tiny3d::Image &dst, tiny3d::Point p, const char *ch, tiny3d::UInt ch_num, tiny3d::Color color, tiny3d::UInt scale, const tiny3d::URect *dst_rect);
@@ -80,7 +71,20 @@ internal_impl::IVertex ToI(const tiny3d::Vertex &v)
 	return ToI(v, nullptr);
 }
 
-void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+// @algo IsInFront
+// @info Checks that all vertices of a triangle are in front of the eye. Triangles with a vertex at or behind the eye must be clipped before they are drawn (see tiny3d::ProjectTriangle), and are otherwise discarded.
+// @in a, b, c -> The vertices.
+// @out TRUE if every vertex has a positive and finite 1/z.
+template < typename vert_t >
+bool IsInFront(const vert_t &a, const vert_t &b, const vert_t &c)
+{
+	// written so that NaN fails
+	const float max = std::numeric_limits<float>::max();
+	return a.w > 0.0f && a.w <= max && b.w > 0.0f && b.w <= max && c.w > 0.0f && c.w <= max;
+}
+
+template < typename depth_t >
+void internal_impl::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
 	const URect srect = URect{ { 0, 0 }, { UInt(dst.GetWidth()), UInt(dst.GetHeight()) } };
 	const URect rect = (dst_rect != nullptr) ? tiny3d::Clip(*dst_rect, srect) : srect;
@@ -90,10 +94,9 @@ void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, ti
 		const Color  pixel = dst.GetColor(q);
 		const UInt   zi    = q.x + q.y * dst.GetWidth();
 //		const float  sz    = a.v.z.ToFloat();
-		const float  sz    = a.v.z;
-		const float  dz    = (zread != nullptr) ? (*zread)[zi] : std::numeric_limits<float>::infinity();
+		const depth_t depth = EncodeDepth<depth_t>((depth_format == DepthFormat_InvZ) ? 1.0f / a.v.z : a.v.z, depth_format);
 
-		if (sz <= dz && pixel.blend != Color::Transparent) {
+		if ((zread == nullptr || DepthTest(depth, (*zread)[zi], depth_format)) && pixel.blend != Color::Transparent) {
 
 			const Color col = a.c;
 			const Color texel = (tex != nullptr) ? tex->GetColor(a.t) : Color{ 255, 255, 255, Color::Solid };
@@ -102,14 +105,14 @@ void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, ti
 			{
 			case Color::Solid:
 				dst.SetColor(q, Dither2x2(texel * col, q));
-				if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+				if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 				break;
 			case Color::AddAlpha:
 				dst.SetColor(q, Dither2x2(dst.GetColor(q) + texel * col, q));
 				break;
 			case Color::Emissive:
 				dst.SetColor(q, texel);
-				if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+				if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 				break;
 			case Color::EmissiveAddAlpha:
 				dst.SetColor(q, Dither2x2(dst.GetColor(q) + texel, q));
@@ -120,18 +123,34 @@ void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, ti
 	}
 }
 
-void internal_impl::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, internal_impl::IVertex a, internal_impl::IVertex b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
-	SInt min_x = 0;
-	SInt max_x = SInt(dst.GetWidth()) - 1;
-	SInt min_y = 0;
-	SInt max_y = SInt(dst.GetHeight()) - 1;
-	if (dst_rect != nullptr) {
-		min_y = tiny3d::Max(min_y, SInt(dst_rect->a.y));
-		max_y = tiny3d::Min(max_y, SInt(dst_rect->b.y) - 1);
-		min_x = tiny3d::Max(min_x, SInt(dst_rect->a.x));
-		max_x = tiny3d::Min(max_x, SInt(dst_rect->b.x) - 1);
-	}
+	internal_impl::DrawPoint(dst, zread, zwrite, a, tex, dst_rect, depth_format);
+}
+
+void tiny3d::DrawPoint(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	internal_impl::DrawPoint(dst, zread, zwrite, a, tex, dst_rect, depth_format);
+}
+
+void tiny3d::DrawPoint(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	internal_impl::DrawPoint<float>(dst, nullptr, nullptr, a, tex, dst_rect, depth_format);
+}
+
+template < typename depth_t >
+void internal_impl::DrawLine(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, internal_impl::IVertex a, internal_impl::IVertex b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	// NOTE: The line is only clipped against the destination, while the mask rectangle discards individual pixels, so that lines split across the tiles of a tiny3d::TileRenderer are stepped exactly like the unsplit line.
+	const URect srect = URect{ { 0, 0 }, { UInt(dst.GetWidth()), UInt(dst.GetHeight()) } };
+	const URect rect  = (dst_rect != nullptr) ? tiny3d::Clip(*dst_rect, srect) : srect;
+	if (tiny3d::Max(a.p.x, b.p.x) < SInt(rect.a.x) || tiny3d::Min(a.p.x, b.p.x) >= SInt(rect.b.x)) { return; }
+	if (tiny3d::Max(a.p.y, b.p.y) < SInt(rect.a.y) || tiny3d::Min(a.p.y, b.p.y) >= SInt(rect.b.y)) { return; }
+
+	const SInt min_x = 0;
+	const SInt max_x = SInt(dst.GetWidth()) - 1;
+	const SInt min_y = 0;
+	const SInt max_y = SInt(dst.GetHeight()) - 1;
 
 	// NOTE: Discard or clip lines.
 	// BUG: Clipping is off by a few pixels here and there at times.
@@ -166,15 +185,15 @@ void internal_impl::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zre
 	float B = a.b;
 	for (SInt i = 0; i <= steps; i++) {
 		Point p = { SInt(X), SInt(Y) };
-		if (p.x >= min_x && p.x <= max_x && p.y >= min_y && p.y <= max_y) {
+		if (p.x >= SInt(rect.a.x) && p.x < SInt(rect.b.x) && p.y >= SInt(rect.a.y) && p.y < SInt(rect.b.y)) {
 
 			const UPoint q     = { UInt(p.x), UInt(p.y) };
 			const Color  pixel = dst.GetColor(q);
 			const UInt   zi    = q.x + q.y * dst.GetWidth();
 			const float  sz    = 1 / W;
-			const float  dz    = (zread != nullptr) ? (*zread)[zi] : std::numeric_limits<float>::infinity();
+			const depth_t depth = EncodeDepth<depth_t>((depth_format == DepthFormat_InvZ) ? W : sz, depth_format);
 
-			if (sz <= dz && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
+			if ((zread == nullptr || DepthTest(depth, (*zread)[zi], depth_format)) && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
 
 				const Color col = {
 					Byte(R * sz),
@@ -189,14 +208,14 @@ void internal_impl::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zre
 				{
 				case Color::Solid:
 					dst.SetColor(q, Dither2x2(texel * col, q));
-					if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+					if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 					break;
 				case Color::AddAlpha:
 					dst.SetColor(q, Dither2x2(dst.GetColor(q) + texel * col, q));
 					break;
 				case Color::Emissive:
 					dst.SetColor(q, texel);
-					if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+					if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 					break;
 				case Color::EmissiveAddAlpha:
 					dst.SetColor(q, Dither2x2(dst.GetColor(q) + texel, q));
@@ -217,60 +236,36 @@ void internal_impl::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zre
 	}
 }
 
-void tiny3d::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
-{
-	internal_impl::DrawLine(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), tex, dst_rect);
-}
-
-struct WidePoint
-{
-	WideSInt x, y;
-};
-struct WideColor
-{
-	WideSInt r, g, b, blend;
-};
-
-WideColor operator+(WideColor l, const WideColor &r)
+void tiny3d::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
-	l.r += r.r;
-	l.g += r.g;
-	l.b += r.b;
-	return l;
+	internal_impl::DrawLine(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), tex, dst_rect, depth_format);
 }
 
-WideColor operator-(WideColor l, const WideColor &r)
+void tiny3d::DrawLine(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
-	l.r -= r.r;
-	l.g -= r.g;
-	l.b -= r.b;
-	return l;
+	internal_impl::DrawLine(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), tex, dst_rect, depth_format);
 }
 
-WideColor operator*(WideColor l, const WideReal &r)
+void tiny3d::DrawLine(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
-	return WideColor{
-		WideSInt(WideReal(l.r) * r),
-		WideSInt(WideReal(l.g) * r),
-		WideSInt(WideReal(l.b) * r),
-		l.blend
-	};
+	internal_impl::DrawLine<float>(dst, nullptr, nullptr, ToI(a, tex), ToI(b, tex), tex, dst_rect, depth_format);
 }
 
-tiny3d::SXInt DetermineHalfspace(tiny3d::Point a, tiny3d::Point b, tiny3d::Point point)
+// @algo SelectFastPipelines
+// @info Selects the SIMD backend of the _Fast functions for the SIMD level in use. See tiny3d::GetSIMDLevel.
+// @out The pipelines of the backend.
+template < typename depth_t >
+const internal_impl::FastPipelines<depth_t> &SelectFastPipelines( void )
 {
-	return tiny3d::SXInt(b.x - a.x) * tiny3d::SXInt(point.y - a.y) - tiny3d::SXInt(b.y - a.y) * tiny3d::SXInt(point.x - a.x);
-}
-
-tiny3d::WideSInt DetermineHalfspace_Fast(tiny3d::Point a, tiny3d::Point b, const WidePoint &point)
-{
-	return WideSInt(b.x - a.x) * (point.y - WideSInt(a.y)) - WideSInt(b.y - a.y) * (point.x - WideSInt(a.x));
-}
-
-bool IsTopLeft(tiny3d::Point a, tiny3d::Point b)
-{
-	// strictly connected to winding order
-	return (a.x < b.x && b.y == a.y) || (a.y > b.y);
+#if TINY_SIMD_DISPATCH
+	switch (tiny3d::GetSIMDLevel()) {
+	case SIMDLevel_AVX512: return internal_impl::simd_avx512::GetFastPipelines<depth_t>();
+	case SIMDLevel_AVX2:   return internal_impl::simd_avx2::GetFastPipelines<depth_t>();
+	default:               return internal_impl::simd_sse::GetFastPipelines<depth_t>();
+	}
+#else
+	return internal_impl::TINY_SIMD_NAMESPACE::GetFastPipelines<depth_t>();
+#endif
 }
 
 /*bool ShouldDivide(SXInt req_prec)
@@ -292,26 +287,28 @@ internal_impl::IVertex MidVertex(const internal_impl::IVertex &a, const internal
 	return ab;
 }
 
-void DrawSubdivTri(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+template < typename depth_t >
+void DrawSubdivTri(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
 	internal_impl::IVertex ab = MidVertex(a, b);
 	internal_impl::IVertex bc = MidVertex(b, c);
 	internal_impl::IVertex ca = MidVertex(c, a);
-	internal_impl::DrawTriangle(dst, zread, zwrite, a,  ab, ca, tex, dst_rect);
-	internal_impl::DrawTriangle(dst, zread, zwrite, ab, b,  bc, tex, dst_rect);
-	internal_impl::DrawTriangle(dst, zread, zwrite, ca, bc, c,  tex, dst_rect);
-	internal_impl::DrawTriangle(dst, zread, zwrite, ca, ab, bc, tex, dst_rect);
+	internal_impl::DrawTriangle(dst, zread, zwrite, a,  ab, ca, tex, dst_rect, depth_format, CullMode_CCW);
+	internal_impl::DrawTriangle(dst, zread, zwrite, ab, b,  bc, tex, dst_rect, depth_format, CullMode_CCW);
+	internal_impl::DrawTriangle(dst, zread, zwrite, ca, bc, c,  tex, dst_rect, depth_format, CullMode_CCW);
+	internal_impl::DrawTriangle(dst, zread, zwrite, ca, ab, bc, tex, dst_rect, depth_format, CullMode_CCW);
 }
 
-void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+template < typename depth_t >
+void RasterizeTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
 	// AABB Clipping
 	SInt min_y = tiny3d::Max(tiny3d::Min(a.p.y, b.p.y, c.p.y), SInt(0));
 	SInt max_y = tiny3d::Min(tiny3d::Max(a.p.y, b.p.y, c.p.y), SInt(dst.GetHeight() - 1));
-	if (max_y - min_y <= 0) { return; }
+	if (max_y - min_y <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 	SInt min_x = tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), SInt(0));
 	SInt max_x = tiny3d::Min(tiny3d::Max(a.p.x, b.p.x, c.p.x), SInt(dst.GetWidth() - 1));
-	if (max_x - min_x <= 0) { return; }
+	if (max_x - min_x <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 
 	if (dst_rect != nullptr) {
 		min_y = SInt(tiny3d::Max(UInt(min_y), dst_rect->a.y));
@@ -320,6 +317,10 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 		max_x = SInt(tiny3d::Min(UInt(max_x), dst_rect->b.x - 1));
 	}
 
+	TINY3D_STATS_ADD(triangles_rasterized, 1);
+	TINY3D_STATS_ADD(bbox_pixels, BoundingBoxArea(Point{ min_x, min_y }, Point{ max_x, max_y }));
+	TINY3D_STATS_TIME(RenderStage_Raster);
+
 	// Triangle setup
 	tiny3d::Point p    = { min_x, min_y };
 	SXInt         w0_y = DetermineHalfspace(b.p, c.p, p);
@@ -353,27 +354,48 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 	w1_y += IsTopLeft(c.p, a.p) ? 0 : -1;
 	w2_y += IsTopLeft(a.p, b.p) ? 0 : -1;
 
+	const bool scanlines   = PreferScanlines(w0_y + w1_y + w2_y, Point{ min_x, min_y }, Point{ max_x, max_y });
+	const SInt w_x_inc[3] = { w0_x_inc, w1_x_inc, w2_x_inc };
+
 	for (p.y = min_y; p.y <= max_y; ++p.y) {
 
-		SInt w0 = SInt(w0_y);
-		SInt w1 = SInt(w1_y);
-		SInt w2 = SInt(w2_y);
+		// only visit the covered pixels of the scanline if most of the bounding box is empty
+		SInt x0 = min_x;
+		SInt x1 = max_x;
+		if (scanlines) {
+			const SXInt            w_y[3]  = { w0_y, w1_y, w2_y };
+			const SpanBuffer::Span covered = ClipScanline(w_y, w_x_inc, min_x, max_x);
+			x0 = SInt(covered.a);
+			x1 = SInt(covered.b) - 1;
+		}
+		const SInt dx = x0 - min_x;
+
+		SInt w0 = SInt(w0_y) + w0_x_inc * dx;
+		SInt w1 = SInt(w1_y) + w1_x_inc * dx;
+		SInt w2 = SInt(w2_y) + w2_x_inc * dx;
 
-		float l0 = l0_y;
-		float l1 = l1_y;
-		float l2 = l2_y;
+		float l0 = l0_y + l0_x_inc * dx;
+		float l1 = l1_y + l1_x_inc * dx;
+		float l2 = l2_y + l2_x_inc * dx;
 
-		for (p.x = min_x; p.x <= max_x; ++p.x) {
+		for (p.x = x0; p.x <= x1; ++p.x) {
 
 			if ((w0 | w1 | w2) >= 0) {
 
 				const UPoint q     = { UInt(p.x), UInt(p.y) };
 				const Color  pixel = dst.GetColor(q);
 				const UInt   zi    = q.x + q.y * dst.GetWidth();
-				const float  sz    = 1.0f / (a.w * l0 + b.w * l1 + c.w * l2);
-				const float  dz    = (zread != nullptr) ? (*zread)[zi] : std::numeric_limits<float>::infinity();
+				const float  w     = a.w * l0 + b.w * l1 + c.w * l2;
+				const depth_t depth = EncodeDepth<depth_t>((depth_format == DepthFormat_InvZ) ? w : 1.0f / w, depth_format);
+
+				const bool depth_pass = zread == nullptr || DepthTest(depth, (*zread)[zi], depth_format);
+				TINY3D_STATS_ADD(fragments_covered, 1);
+				TINY3D_STATS_ADD(fragments_depth_rejected, depth_pass ? 0 : 1);
+				TINY3D_STATS_ADD(fragments_stencil_rejected, depth_pass && pixel.blend == Color::Transparent ? 1 : 0);
 
-				if (sz <= dz && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
+				if (depth_pass && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
+
+					const float sz = 1.0f / w;
 
 					const float L0 = l0 * sz;
 					const float L1 = l1 * sz;
@@ -389,18 +411,20 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 					const Color texel = (tex != nullptr) ? tex->GetColor(UPoint{ UInt(a.u * L0 + b.u * L1 + c.u * L2), UInt(a.v * L0 + b.v * L1 + c.v * L2) }) : Color{ 255, 255, 255, Color::Solid };
 //					const Color texel = (tex != nullptr) ? tex->GetColor(Dither2x2(Vector2{ a.u * L0 + b.u * L1 + c.u * L2, a.v * L0 + b.v * L1 + c.v * L2}, q)) : Color{ 255, 255, 255, Color::Solid }; // Dithered texture filtering (can look good if texture is relatively high resolution)
 
+					TINY3D_STATS_ADD(texels_fetched, tex != nullptr ? 1 : 0);
+					TINY3D_STATS_ADD(fragments_written, texel.blend != Color::Transparent ? 1 : 0);
 					switch (texel.blend)
 					{
 					case Color::Solid:
 						dst.SetColor(q, Dither2x2(texel * col, q));
-						if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+						if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 						break;
 					case Color::AddAlpha:
 						dst.SetColor(q, Dither2x2(pixel + texel * col, q));
 						break;
 					case Color::Emissive:
 						dst.SetColor(q, texel);
-						if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+						if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 						break;
 					case Color::EmissiveAddAlpha:
 						dst.SetColor(q, Dither2x2(pixel + texel, q));
@@ -429,197 +453,71 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 	}
 }
 #include <iostream>
-void internal_impl::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+template < typename depth_t >
+void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
 {
-	static constexpr SInt SIMD_X_TILE      = TINY_WIDTH;
-	static constexpr SInt SIMD_Y_TILE      = 1;
-	static constexpr SInt X_COORD_OFFSET[] = TINY_OFFSETS;
-	static constexpr SInt Y_COORD_OFFSET[] = TINY_NO_OFFSETS;
-
-	// AABB Clipping
-	SInt min_y = tiny3d::Max(tiny3d::Min(a.p.y, b.p.y, c.p.y), SInt(0));
-	SInt max_y = tiny3d::Min(tiny3d::Max(a.p.y, b.p.y, c.p.y), SInt(dst.GetHeight() - 1));
-	if (max_y - min_y <= 0) { return; }
-	SInt min_x = TINY_FLOOR(tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), SInt(0)));
-	SInt max_x = tiny3d::Min(tiny3d::Max(a.p.x, b.p.x, c.p.x), SInt(dst.GetWidth() - 1));
-	if (max_x - min_x <= 0) { return; }
-
-	if (dst_rect != nullptr) {
-		min_y = SInt(tiny3d::Max(UInt(min_y), dst_rect->a.y));
-		max_y = SInt(tiny3d::Min(UInt(max_y), dst_rect->b.y - 1));
-		min_x = SInt(tiny3d::Max(UInt(min_x), dst_rect->a.x));
-		max_x = SInt(tiny3d::Min(UInt(max_x), dst_rect->b.x - 1));
-	}
-
-	// Interpolation/triangle setup
-	const WidePoint p        = { WideSInt(min_x) + WideSInt(X_COORD_OFFSET), WideSInt(min_y) + WideSInt(Y_COORD_OFFSET) };
-	WidePoint       q        = p;
-	WideSInt        w0_y     = DetermineHalfspace_Fast(b.p, c.p, p);
-	WideSInt        w1_y     = DetermineHalfspace_Fast(c.p, a.p, p);
-	WideSInt        w2_y     = DetermineHalfspace_Fast(a.p, b.p, p);
-	const WideSInt  w2_x_inc = (a.p.y - b.p.y) * SIMD_X_TILE;
-	const WideSInt  w2_y_inc = (b.p.x - a.p.x) * SIMD_Y_TILE;
-	const WideSInt  w0_x_inc = (b.p.y - c.p.y) * SIMD_X_TILE;
-	const WideSInt  w0_y_inc = (c.p.x - b.p.x) * SIMD_Y_TILE;
-	const WideSInt  w1_x_inc = (c.p.y - a.p.y) * SIMD_X_TILE;
-	const WideSInt  w1_y_inc = (a.p.x - c.p.x) * SIMD_Y_TILE;
-	WideReal        l0_y     = WideReal(w0_y);
-	WideReal        l1_y     = WideReal(w1_y);
-	WideReal        l2_y     = WideReal(w2_y);
-	const WideReal  l0_x_inc = WideReal(w0_x_inc);
-	const WideReal  l1_x_inc = WideReal(w1_x_inc);
-	const WideReal  l2_x_inc = WideReal(w2_x_inc);
-	const WideReal  l0_y_inc = WideReal(w0_y_inc);
-	const WideReal  l1_y_inc = WideReal(w1_y_inc);
-	const WideReal  l2_y_inc = WideReal(w2_y_inc);
-	const WideReal  waw      = a.w;
-	const WideReal  wbw      = b.w;
-	const WideReal  wcw      = c.w;
-
-	w0_y += IsTopLeft(b.p, c.p) ? WideSInt(0) : WideSInt(-1); // add offsets to coordinates to enforce fill convention
-	w1_y += IsTopLeft(c.p, a.p) ? WideSInt(0) : WideSInt(-1);
-	w2_y += IsTopLeft(a.p, b.p) ? WideSInt(0) : WideSInt(-1);
-
-	const float *zread_offset  = zread  != nullptr ? &((*zread)[UInt(min_x) + dst.GetWidth() * UInt(min_y)])  : nullptr;
-	float       *zwrite_offset = zwrite != nullptr ? &((*zwrite)[UInt(min_x) + dst.GetWidth() * UInt(min_y)]) : nullptr;
-
-	for (int y = min_y; y <= max_y; y += SIMD_Y_TILE) {
-
-		WideSInt w0 = w0_y;
-		WideSInt w1 = w1_y;
-		WideSInt w2 = w2_y;
-
-		WideReal l0 = l0_y;
-		WideReal l1 = l1_y;
-		WideReal l2 = l2_y;
-
-		const float *zr = zread_offset;
-		float       *zw = zwrite_offset;
-
-		for (int x = min_x; x <= max_x; x += SIMD_X_TILE) {
-
-			WideBool fragment_mask = (w0 | w1 | w2) >= 0;
-
-			if (fragment_mask.all_fail() == false) {
-
-				const WideReal sz = WideReal(1.0f) / (waw * l0 + wbw * l1 + wcw * l2);
-				const WideReal dz = (zr) ? WideReal(zr) : std::numeric_limits<float>::infinity();
-
-				fragment_mask = fragment_mask & (sz <= dz);
-
-				if (fragment_mask.all_fail() == false) {
-
-					WideColor pixel;
-					for (int i = 0; i < TINY_WIDTH; ++i) {
-						Color o = dst.GetColor(UPoint{ UInt(reinterpret_cast<SInt*>(&q.x)[i]), UInt(reinterpret_cast<SInt*>(&q.y)[i]) });
-						reinterpret_cast<SInt*>(&pixel.r)[i]     = o.r;
-						reinterpret_cast<SInt*>(&pixel.g)[i]     = o.g;
-						reinterpret_cast<SInt*>(&pixel.b)[i]     = o.b;
-						reinterpret_cast<SInt*>(&pixel.blend)[i] = o.blend;
-					}
-
-					fragment_mask = fragment_mask & (pixel.blend != WideSInt(Color::Transparent));
-
-					if (fragment_mask.all_fail() == false) { // use transparency bit as a 1-bit stencil
-
-						const WideReal L0 = l0 * sz;
-						const WideReal L1 = l1 * sz;
-						const WideReal L2 = l2 * sz;
-
-						WideSInt u = WideSInt(WideReal(a.u) * L0 + WideReal(b.u) * L1 + WideReal(c.u) * L2);
-						WideSInt v = WideSInt(WideReal(a.v) * L0 + WideReal(b.v) * L1 + WideReal(c.v) * L2);
-
-						const WideColor col = {
-							WideSInt(WideReal(a.r) * L0 + WideReal(b.r) * L1 + WideReal(c.r) * L2),
-							WideSInt(WideReal(a.g) * L0 + WideReal(b.g) * L1 + WideReal(c.g) * L2),
-							WideSInt(WideReal(a.b) * L0 + WideReal(b.b) * L1 + WideReal(c.b) * L2),
-							WideSInt(Color::Solid)
-						};
-
-						for (int i = 0; i < TINY_WIDTH; ++i) {
-
-							if (reinterpret_cast<const UInt*>(&fragment_mask)[i] == 0) { continue; }
-
-							const Color texel = (tex) ? tex->GetColor(UPoint{ UInt(reinterpret_cast<SInt*>(&u)[i]), UInt(reinterpret_cast<SInt*>(&v)[i]) }) : Color{ 255, 255, 255, Color::Solid };
-							const Color cx = Color{
-								Byte(reinterpret_cast<const SInt*>(&col.r)[i]),
-								Byte(reinterpret_cast<const SInt*>(&col.g)[i]),
-								Byte(reinterpret_cast<const SInt*>(&col.b)[i]),
-								Color::Solid
-							};
-							const UPoint pt = UPoint{ UInt(reinterpret_cast<SInt*>(&q.x)[i]), UInt(reinterpret_cast<SInt*>(&q.y)[i]) };
-							switch (texel.blend)
-							{
-							case Color::Solid:
-								dst.SetColor(pt, Dither2x2(texel * cx, pt));
-								if (zw) { zw[i] = reinterpret_cast<const float*>(&sz)[i]; }
-								break;
-							case Color::AddAlpha:
-								dst.SetColor(pt, Dither2x2(dst.GetColor(pt) + texel * cx, pt));
-								break;
-							case Color::Emissive:
-								dst.SetColor(pt, texel);
-								if (zw) { zw[i] = reinterpret_cast<const float*>(&sz)[i]; }
-								break;
-							case Color::EmissiveAddAlpha:
-								dst.SetColor(pt, Dither2x2(dst.GetColor(pt) + texel, pt));
-								break;
-							default: break;
-							}
-						}
-					}
-				}
-			}
-
-			w0 += w0_x_inc;
-			w1 += w1_x_inc;
-			w2 += w2_x_inc;
-
-			l0 += l0_x_inc;
-			l1 += l1_x_inc;
-			l2 += l2_x_inc;
-
-			q.x += SIMD_X_TILE;
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	if (!IsInFront(a, b, c)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	if (area_x2 > 0) { RasterizeTriangle(dst, zread, zwrite, a, b, c, tex, dst_rect, depth_format); }
+	else             { RasterizeTriangle(dst, zread, zwrite, a, c, b, tex, dst_rect, depth_format); }
+}
 
-			if (zr) { zr += SIMD_X_TILE; }
-			if (zw) { zw += SIMD_X_TILE; }
-		}
+template < typename depth_t >
+void internal_impl::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	if (!IsInFront(a, b, c)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const typename internal_impl::FastPipelines<depth_t>::ColorPipeline *PIPELINES = SelectFastPipelines<depth_t>().color;
+	if (area_x2 > 0) { PIPELINES[PipelineKey_Fast(zread, zwrite, tex)](dst, zread, zwrite, a, b, c, tex, dst_rect, perspective, depth_format, hiz); }
+	else             { PIPELINES[PipelineKey_Fast(zread, zwrite, tex)](dst, zread, zwrite, a, c, b, tex, dst_rect, perspective, depth_format, hiz); }
+}
 
-		w0_y += w0_y_inc;
-		w1_y += w1_y_inc;
-		w2_y += w2_y_inc;
+void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, depth_format, cull_mode);
+}
 
-		l0_y += l0_y_inc;
-		l1_y += l1_y_inc;
-		l2_y += l2_y_inc;
+void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, depth_format, cull_mode);
+}
 
-		q.x = p.x;
-		q.y += SIMD_Y_TILE;
+void tiny3d::DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle<float>(dst, nullptr, nullptr, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, depth_format, cull_mode);
+}
 
-		if (zread_offset)  { zread_offset  += dst.GetWidth() * SIMD_Y_TILE; }
-		if (zwrite_offset) { zwrite_offset += dst.GetWidth() * SIMD_Y_TILE; }
-	}
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, perspective, depth_format, hiz, cull_mode);
 }
 
-void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
 {
-	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect);
+	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, perspective, depth_format, hiz, cull_mode);
 }
 
-void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect)
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
 {
-	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect);
+	internal_impl::DrawTriangle_Fast<float>(dst, nullptr, nullptr, ToI(a, tex), ToI(b, tex), ToI(c, tex), tex, dst_rect, perspective, depth_format, nullptr, cull_mode);
 }
 
-void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect)
+template < typename depth_t >
+void RasterizeTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
 {
 	// AABB Clipping
 	SInt min_y = tiny3d::Max(tiny3d::Min(a.p.y, b.p.y, c.p.y), SInt(0));
 	SInt max_y = tiny3d::Min(tiny3d::Max(a.p.y, b.p.y, c.p.y), SInt(dst.GetHeight() - 1));
-	if (max_y - min_y <= 0) { return; }
+	if (max_y - min_y <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 	SInt min_x = tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), SInt(0));
 	SInt max_x = tiny3d::Min(tiny3d::Max(a.p.x, b.p.x, c.p.x), SInt(dst.GetWidth() - 1));
-	if (max_x - min_x <= 0) { return; }
+	if (max_x - min_x <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 
 	if (dst_rect != nullptr) {
 		min_y = SInt(tiny3d::Max(UInt(min_y), dst_rect->a.y));
@@ -628,6 +526,10 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 		max_x = SInt(tiny3d::Min(UInt(max_x), dst_rect->b.x - 1));
 	}
 
+	TINY3D_STATS_ADD(triangles_rasterized, 1);
+	TINY3D_STATS_ADD(bbox_pixels, BoundingBoxArea(Point{ min_x, min_y }, Point{ max_x, max_y }));
+	TINY3D_STATS_TIME(RenderStage_Raster);
+
 	// Triangle setup
 	tiny3d::Point p    = { min_x, min_y };
 	SXInt         w0_y = DetermineHalfspace(b.p, c.p, p);
@@ -661,27 +563,48 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 	w1_y += IsTopLeft(c.p, a.p) ? 0 : -1;
 	w2_y += IsTopLeft(a.p, b.p) ? 0 : -1;
 
+	const bool scanlines   = PreferScanlines(w0_y + w1_y + w2_y, Point{ min_x, min_y }, Point{ max_x, max_y });
+	const SInt w_x_inc[3] = { w0_x_inc, w1_x_inc, w2_x_inc };
+
 	for (p.y = min_y; p.y <= max_y; ++p.y) {
 
-		SInt w0 = SInt(w0_y);
-		SInt w1 = SInt(w1_y);
-		SInt w2 = SInt(w2_y);
+		// only visit the covered pixels of the scanline if most of the bounding box is empty
+		SInt x0 = min_x;
+		SInt x1 = max_x;
+		if (scanlines) {
+			const SXInt            w_y[3]  = { w0_y, w1_y, w2_y };
+			const SpanBuffer::Span covered = ClipScanline(w_y, w_x_inc, min_x, max_x);
+			x0 = SInt(covered.a);
+			x1 = SInt(covered.b) - 1;
+		}
+		const SInt dx = x0 - min_x;
+
+		SInt w0 = SInt(w0_y) + w0_x_inc * dx;
+		SInt w1 = SInt(w1_y) + w1_x_inc * dx;
+		SInt w2 = SInt(w2_y) + w2_x_inc * dx;
 
-		float l0 = l0_y;
-		float l1 = l1_y;
-		float l2 = l2_y;
+		float l0 = l0_y + l0_x_inc * dx;
+		float l1 = l1_y + l1_x_inc * dx;
+		float l2 = l2_y + l2_x_inc * dx;
 
-		for (p.x = min_x; p.x <= max_x; ++p.x) {
+		for (p.x = x0; p.x <= x1; ++p.x) {
 
 			if ((w0 | w1 | w2) >= 0) {
 
 				const UPoint q     = { UInt(p.x), UInt(p.y) };
 				const Color  pixel = dst.GetColor(q);
 				const UInt   zi    = q.x + q.y * dst.GetWidth();
-				const float  sz    = 1.0f / (a.w * l0 + b.w * l1 + c.w * l2);
-				const float  dz    = (zread != nullptr) ? (*zread)[zi] : std::numeric_limits<float>::infinity();
+				const float  w     = a.w * l0 + b.w * l1 + c.w * l2;
+				const depth_t depth = EncodeDepth<depth_t>((depth_format == DepthFormat_InvZ) ? w : 1.0f / w, depth_format);
+
+				const bool depth_pass = zread == nullptr || DepthTest(depth, (*zread)[zi], depth_format);
+				TINY3D_STATS_ADD(fragments_covered, 1);
+				TINY3D_STATS_ADD(fragments_depth_rejected, depth_pass ? 0 : 1);
+				TINY3D_STATS_ADD(fragments_stencil_rejected, depth_pass && pixel.blend == Color::Transparent ? 1 : 0);
 
-				if (sz <= dz && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
+				if (depth_pass && pixel.blend != Color::Transparent) { // use transparency bit as a 1-bit stencil
+
+					const float sz = 1.0f / w;
 
 					const float L0 = l0 * sz;
 					const float L1 = l1 * sz;
@@ -698,18 +621,20 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 					);
 //					const Color   lumel = lightmap.GetColor(Dither2x2(Vector2{ a.lu * L0 + b.lu * L1 + c.lu * L2, a.lv * L0 + b.lv * L1 + c.lv * L2 }, q)); // Dithered lightmap (looks terrible)
 
+					TINY3D_STATS_ADD(texels_fetched, (tex != nullptr ? 1 : 0) + 4);
+					TINY3D_STATS_ADD(fragments_written, texel.blend != Color::Transparent ? 1 : 0);
 					switch (texel.blend)
 					{
 					case Color::Solid:
 						dst.SetColor(q, Dither2x2(texel * lumel, q));
-						if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+						if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 						break;
 					case Color::AddAlpha:
 						dst.SetColor(q, Dither2x2(pixel + texel * lumel, q));
 						break;
 					case Color::Emissive:
 						dst.SetColor(q, texel);
-						if (zwrite != nullptr) { (*zwrite)[zi] = sz; }
+						if (zwrite != nullptr) { (*zwrite)[zi] = depth; }
 						break;
 					case Color::EmissiveAddAlpha:
 						dst.SetColor(q, Dither2x2(pixel + texel, q));
@@ -738,25 +663,198 @@ void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float>
 	}
 }
 
-void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect)
+void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, depth_format, cull_mode);
+}
+
+void tiny3d::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, depth_format, cull_mode);
+}
+
+void tiny3d::DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle<float>(dst, nullptr, nullptr, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, depth_format, cull_mode);
+}
+
+template < typename depth_t >
+void internal_impl::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	if (!IsInFront(a, b, c)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	if (area_x2 > 0) { RasterizeTriangle(dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, depth_format); }
+	else             { RasterizeTriangle(dst, zread, zwrite, a, c, b, tex, lightmap, dst_rect, depth_format); }
+}
+
+template < typename depth_t >
+void internal_impl::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	if (!IsInFront(a, b, c)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const typename internal_impl::FastPipelines<depth_t>::LightmapPipeline *PIPELINES = SelectFastPipelines<depth_t>().lightmap;
+	if (area_x2 > 0) { PIPELINES[PipelineKey_Fast(zread, zwrite, tex)](dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, perspective, depth_format, hiz); }
+	else             { PIPELINES[PipelineKey_Fast(zread, zwrite, tex)](dst, zread, zwrite, a, c, b, tex, lightmap, dst_rect, perspective, depth_format, hiz); }
+}
+
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangle_Fast<float>(dst, nullptr, nullptr, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+// @data ColorShader_Span
+// @info Shades the fragments of a vertex colored triangle drawn with a span buffer. Same as DrawTriangle.
+struct ColorShader_Span
+{
+	tiny3d::Image                &dst;
+	const internal_impl::IVertex &a, &b, &c;
+	const tiny3d::Texture        *tex;
+
+	// @algo ()
+	// @info Shades a fragment.
+	// @in
+	//   q -> The fragment coordinate.
+	//   pixel -> The color already stored at q.
+	//   l0, l1, l2 -> The barycentric coordinates of the fragment.
+	// @out TRUE if the fragment was opaque and now covers the pixel.
+	bool operator()(tiny3d::UPoint q, tiny3d::Color pixel, float l0, float l1, float l2) const
+	{
+		const float sz = 1.0f / (a.w * l0 + b.w * l1 + c.w * l2);
+
+		const float L0 = l0 * sz;
+		const float L1 = l1 * sz;
+		const float L2 = l2 * sz;
+
+		const Color col = {
+			Byte(a.r * L0 + b.r * L1 + c.r * L2),
+			Byte(a.g * L0 + b.g * L1 + c.g * L2),
+			Byte(a.b * L0 + b.b * L1 + c.b * L2),
+			Color::Solid
+		};
+
+		const Color texel = (tex != nullptr) ? tex->GetColor(UPoint{ UInt(a.u * L0 + b.u * L1 + c.u * L2), UInt(a.v * L0 + b.v * L1 + c.v * L2) }) : Color{ 255, 255, 255, Color::Solid };
+
+		TINY3D_STATS_ADD(texels_fetched, tex != nullptr ? 1 : 0);
+		TINY3D_STATS_ADD(fragments_written, texel.blend != Color::Transparent ? 1 : 0);
+		switch (texel.blend)
+		{
+		case Color::Solid:
+			dst.SetColor(q, Dither2x2(texel * col, q));
+			return true;
+		case Color::AddAlpha:
+			dst.SetColor(q, Dither2x2(pixel + texel * col, q));
+			return false;
+		case Color::Emissive:
+			dst.SetColor(q, texel);
+			return true;
+		case Color::EmissiveAddAlpha:
+			dst.SetColor(q, Dither2x2(pixel + texel, q));
+			return false;
+		default: return false;
+		}
+	}
+};
+
+// @data LightmapShader_Span
+// @info Shades the fragments of a lightmap shaded triangle drawn with a span buffer. Same as DrawTriangle.
+struct LightmapShader_Span
+{
+	tiny3d::Image                 &dst;
+	const internal_impl::ILVertex &a, &b, &c;
+	const tiny3d::Texture         *tex;
+	const tiny3d::Texture         &lightmap;
+
+	// @algo ()
+	// @info Shades a fragment.
+	// @in
+	//   q -> The fragment coordinate.
+	//   pixel -> The color already stored at q.
+	//   l0, l1, l2 -> The barycentric coordinates of the fragment.
+	// @out TRUE if the fragment was opaque and now covers the pixel.
+	bool operator()(tiny3d::UPoint q, tiny3d::Color pixel, float l0, float l1, float l2) const
+	{
+		const float sz = 1.0f / (a.w * l0 + b.w * l1 + c.w * l2);
+
+		const float L0 = l0 * sz;
+		const float L1 = l1 * sz;
+		const float L2 = l2 * sz;
+
+		const Color   texel = (tex != nullptr) ? tex->GetColor(UPoint{ UInt(a.u * L0 + b.u * L1 + c.u * L2), UInt(a.v * L0 + b.v * L1 + c.v * L2) }) : Color{ 255, 255, 255, Color::Solid };
+		const Vector2 luv   = Vector2{ a.lu * L0 + b.lu * L1 + c.lu * L2, a.lv * L0 + b.lv * L1 + c.lv * L2 };
+		const UPoint  l00   = UPoint{ UInt(luv.x),   UInt(luv.y) };
+		const Color   lumel = Bilerp(
+			lightmap.GetColor(l00),                      lightmap.GetColor(UPoint{ l00.x+1, l00.y }),
+			lightmap.GetColor(UPoint{ l00.x, l00.y+1 }), lightmap.GetColor(UPoint{ l00.x+1, l00.y+1 }),
+			luv.x - l00.x,
+			luv.y - l00.y
+		);
+
+		TINY3D_STATS_ADD(texels_fetched, (tex != nullptr ? 1 : 0) + 4);
+		TINY3D_STATS_ADD(fragments_written, texel.blend != Color::Transparent ? 1 : 0);
+		switch (texel.blend)
+		{
+		case Color::Solid:
+			dst.SetColor(q, Dither2x2(texel * lumel, q));
+			return true;
+		case Color::AddAlpha:
+			dst.SetColor(q, Dither2x2(pixel + texel * lumel, q));
+			return false;
+		case Color::Emissive:
+			dst.SetColor(q, texel);
+			return true;
+		case Color::EmissiveAddAlpha:
+			dst.SetColor(q, Dither2x2(pixel + texel, q));
+			return false;
+		default: return false;
+		}
+	}
+};
+
+// @algo CountGapPixels
+// @in
+//   spans -> A span buffer.
+//   ngaps -> The number of uncovered parts found by the last call to GetUncovered.
+// @out The number of pixels in the uncovered parts.
+tiny3d::UInt CountGapPixels(const tiny3d::SpanBuffer &spans, tiny3d::UInt ngaps)
 {
-	internal_impl::DrawTriangle(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect);
+	tiny3d::UInt n = 0;
+	for (tiny3d::UInt i = 0; i < ngaps; ++i) {
+		n += spans.GetGap(i).b - spans.GetGap(i).a;
+	}
+	return n;
 }
 
-void internal_impl::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect)
+// @algo RasterizeTriangle_Span
+// @info Traverses a triangle one scanline at a time. The covered span of each scanline is clipped against the span buffer, only the uncovered gaps are shaded, and the runs of opaque fragments are then added to the span buffer.
+template < typename vert_t, typename shader_t >
+void RasterizeTriangle_Span(tiny3d::Image &dst, tiny3d::SpanBuffer &spans, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::URect *dst_rect, const shader_t &shader)
 {
-	static constexpr SInt SIMD_X_TILE      = TINY_WIDTH;
-	static constexpr SInt SIMD_Y_TILE      = 1;
-	static constexpr SInt X_COORD_OFFSET[] = TINY_OFFSETS;
-	static constexpr SInt Y_COORD_OFFSET[] = TINY_NO_OFFSETS;
+	TINY3D_ASSERT(spans.GetWidth() == dst.GetWidth() && spans.GetHeight() == dst.GetHeight());
+	if (!IsInFront(a, b, c)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 
 	// AABB Clipping
 	SInt min_y = tiny3d::Max(tiny3d::Min(a.p.y, b.p.y, c.p.y), SInt(0));
 	SInt max_y = tiny3d::Min(tiny3d::Max(a.p.y, b.p.y, c.p.y), SInt(dst.GetHeight() - 1));
-	if (max_y - min_y <= 0) { return; }
-	SInt min_x = TINY_FLOOR(tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), SInt(0)));
+	if (max_y - min_y <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	SInt min_x = tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), SInt(0));
 	SInt max_x = tiny3d::Min(tiny3d::Max(a.p.x, b.p.x, c.p.x), SInt(dst.GetWidth() - 1));
-	if (max_x - min_x <= 0) { return; }
+	if (max_x - min_x <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
 
 	if (dst_rect != nullptr) {
 		min_y = SInt(tiny3d::Max(UInt(min_y), dst_rect->a.y));
@@ -765,200 +863,313 @@ void internal_impl::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<fl
 		max_x = SInt(tiny3d::Min(UInt(max_x), dst_rect->b.x - 1));
 	}
 
-	// Interpolation/triangle setup
-	const WidePoint p        = { WideSInt(min_x) + WideSInt(X_COORD_OFFSET), WideSInt(min_y) + WideSInt(Y_COORD_OFFSET) };
-	WidePoint       q        = p;
-	WideSInt        w0_y     = DetermineHalfspace_Fast(b.p, c.p, p);
-	WideSInt        w1_y     = DetermineHalfspace_Fast(c.p, a.p, p);
-	WideSInt        w2_y     = DetermineHalfspace_Fast(a.p, b.p, p);
-	const WideSInt  w2_x_inc = (a.p.y - b.p.y) * SIMD_X_TILE;
-	const WideSInt  w2_y_inc = (b.p.x - a.p.x) * SIMD_Y_TILE;
-	const WideSInt  w0_x_inc = (b.p.y - c.p.y) * SIMD_X_TILE;
-	const WideSInt  w0_y_inc = (c.p.x - b.p.x) * SIMD_Y_TILE;
-	const WideSInt  w1_x_inc = (c.p.y - a.p.y) * SIMD_X_TILE;
-	const WideSInt  w1_y_inc = (a.p.x - c.p.x) * SIMD_Y_TILE;
-	WideReal        l0_y     = WideReal(w0_y);
-	WideReal        l1_y     = WideReal(w1_y);
-	WideReal        l2_y     = WideReal(w2_y);
-	const WideReal  l0_x_inc = WideReal(w0_x_inc);
-	const WideReal  l1_x_inc = WideReal(w1_x_inc);
-	const WideReal  l2_x_inc = WideReal(w2_x_inc);
-	const WideReal  l0_y_inc = WideReal(w0_y_inc);
-	const WideReal  l1_y_inc = WideReal(w1_y_inc);
-	const WideReal  l2_y_inc = WideReal(w2_y_inc);
-	const WideReal  waw      = a.w;
-	const WideReal  wbw      = b.w;
-	const WideReal  wcw      = c.w;
-
-	w0_y += IsTopLeft(b.p, c.p) ? WideSInt(0) : WideSInt(-1); // add offsets to coordinates to enforce fill convention
-	w1_y += IsTopLeft(c.p, a.p) ? WideSInt(0) : WideSInt(-1);
-	w2_y += IsTopLeft(a.p, b.p) ? WideSInt(0) : WideSInt(-1);
-
-	const float *zread_offset  = zread  != nullptr ? &((*zread)[UInt(min_x) + dst.GetWidth() * UInt(min_y)])  : nullptr;
-	float       *zwrite_offset = zwrite != nullptr ? &((*zwrite)[UInt(min_x) + dst.GetWidth() * UInt(min_y)]) : nullptr;
-
-	for (int y = min_y; y <= max_y; y += SIMD_Y_TILE) {
-
-		WideSInt w0 = w0_y;
-		WideSInt w1 = w1_y;
-		WideSInt w2 = w2_y;
-
-		WideReal l0 = l0_y;
-		WideReal l1 = l1_y;
-		WideReal l2 = l2_y;
-
-		const float *zr = zread_offset;
-		float       *zw = zwrite_offset;
-
-		for (int x = min_x; x <= max_x; x += SIMD_X_TILE) {
-
-			WideBool fragment_mask = (w0 | w1 | w2) >= 0;
-
-			if (fragment_mask.all_fail() == false) {
-
-				const WideReal sz = WideReal(1.0f) / (waw * l0 + wbw * l1 + wcw * l2);
-				const WideReal dz = (zr) ? WideReal(zr) : std::numeric_limits<float>::infinity();
-
-				fragment_mask = fragment_mask & (sz <= dz);
-
-				if (fragment_mask.all_fail() == false) {
-
-					WideColor pixel;
-					for (int i = 0; i < TINY_WIDTH; ++i) {
-						Color o = dst.GetColor(UPoint{ UInt(reinterpret_cast<SInt*>(&q.x)[i]), UInt(reinterpret_cast<SInt*>(&q.y)[i]) });
-						reinterpret_cast<SInt*>(&pixel.r)[i]     = o.r;
-						reinterpret_cast<SInt*>(&pixel.g)[i]     = o.g;
-						reinterpret_cast<SInt*>(&pixel.b)[i]     = o.b;
-						reinterpret_cast<SInt*>(&pixel.blend)[i] = o.blend;
-					}
+	// Triangle setup
+	const SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (area_x2 <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; } // no fragment passes the coverage test of a back facing or degenerate triangle
+	TINY3D_STATS_ADD(triangles_rasterized, 1);
+	TINY3D_STATS_ADD(bbox_pixels, BoundingBoxArea(Point{ min_x, min_y }, Point{ max_x, max_y }));
+	TINY3D_STATS_TIME(RenderStage_Raster);
+	const float   inv_area_x2 = 1.0f / SInt(area_x2);
+	const Point   p           = { min_x, min_y };
+	const SInt    bias[3]     = { // add offsets to coordinates to enforce fill convention
+		IsTopLeft(b.p, c.p) ? 0 : -1,
+		IsTopLeft(c.p, a.p) ? 0 : -1,
+		IsTopLeft(a.p, b.p) ? 0 : -1
+	};
+	SXInt         w_y[3]      = {
+		DetermineHalfspace(b.p, c.p, p) + bias[0],
+		DetermineHalfspace(c.p, a.p, p) + bias[1],
+		DetermineHalfspace(a.p, b.p, p) + bias[2]
+	};
+	const SInt    w_x_inc[3]  = { b.p.y - c.p.y, c.p.y - a.p.y, a.p.y - b.p.y };
+	const SInt    w_y_inc[3]  = { c.p.x - b.p.x, a.p.x - c.p.x, b.p.x - a.p.x };
+
+	for (SInt y = min_y; y <= max_y; ++y) {
 
-					fragment_mask = fragment_mask & (pixel.blend != WideSInt(Color::Transparent));
-
-					if (fragment_mask.all_fail() == false) { // use transparency bit as a 1-bit stencil
-
-						const WideReal L0 = l0 * sz;
-						const WideReal L1 = l1 * sz;
-						const WideReal L2 = l2 * sz;
-
-						const WideSInt u = WideSInt(WideReal(a.u) * L0 + WideReal(b.u) * L1 + WideReal(c.u) * L2);
-						const WideSInt v = WideSInt(WideReal(a.v) * L0 + WideReal(b.v) * L1 + WideReal(c.v) * L2);
-
-						const WideReal lu = WideReal(a.lu) * L0 + WideReal(b.lu) * L1 + WideReal(c.lu) * L2;
-						const WideReal lv = WideReal(a.lv) * L0 + WideReal(b.lv) * L1 + WideReal(c.lv) * L2;
-
-						const WidePoint l00 = { WideSInt(lu),     WideSInt(lv)     };
-						const WidePoint l10 = { WideSInt(lu) + 1, WideSInt(lv)     };
-						const WidePoint l01 = { WideSInt(lu),     WideSInt(lv) + 1 };
-						const WidePoint l11 = { WideSInt(lu) + 1, WideSInt(lv) + 1 };
-						WideColor c00, c10, c01, c11;
-						for (SInt i = 0; i < TINY_WIDTH; ++i) {
-							const Color lc00 = lightmap.GetColor(UPoint{ UInt(reinterpret_cast<const SInt*>(&l00.x)[i]), UInt(reinterpret_cast<const SInt*>(&l00.y)[i]) });
-							const Color lc10 = lightmap.GetColor(UPoint{ UInt(reinterpret_cast<const SInt*>(&l10.x)[i]), UInt(reinterpret_cast<const SInt*>(&l10.y)[i]) });
-							const Color lc01 = lightmap.GetColor(UPoint{ UInt(reinterpret_cast<const SInt*>(&l01.x)[i]), UInt(reinterpret_cast<const SInt*>(&l01.y)[i]) });
-							const Color lc11 = lightmap.GetColor(UPoint{ UInt(reinterpret_cast<const SInt*>(&l11.x)[i]), UInt(reinterpret_cast<const SInt*>(&l11.y)[i]) });
-
-							reinterpret_cast<SInt*>(&c00.r)[i]     = lc00.r;
-							reinterpret_cast<SInt*>(&c00.g)[i]     = lc00.g;
-							reinterpret_cast<SInt*>(&c00.b)[i]     = lc00.b;
-							reinterpret_cast<SInt*>(&c00.blend)[i] = lc00.blend;
-
-							reinterpret_cast<SInt*>(&c10.r)[i]     = lc10.r;
-							reinterpret_cast<SInt*>(&c10.g)[i]     = lc10.g;
-							reinterpret_cast<SInt*>(&c10.b)[i]     = lc10.b;
-							reinterpret_cast<SInt*>(&c10.blend)[i] = lc10.blend;
-
-							reinterpret_cast<SInt*>(&c01.r)[i]     = lc01.r;
-							reinterpret_cast<SInt*>(&c01.g)[i]     = lc01.g;
-							reinterpret_cast<SInt*>(&c01.b)[i]     = lc01.b;
-							reinterpret_cast<SInt*>(&c01.blend)[i] = lc01.blend;
-
-							reinterpret_cast<SInt*>(&c11.r)[i]     = lc11.r;
-							reinterpret_cast<SInt*>(&c11.g)[i]     = lc11.g;
-							reinterpret_cast<SInt*>(&c11.b)[i]     = lc11.b;
-							reinterpret_cast<SInt*>(&c11.blend)[i] = lc11.blend;
-						}
-
-						const WideColor wlumel = Bilerp(
-							c00, c10,
-							c01, c11,
-							lu - WideReal(l00.x),
-							lv - WideReal(l00.y)
-						);
-
-						for (SInt i = 0; i < TINY_WIDTH; ++i) {
-
-							if (reinterpret_cast<const UInt*>(&fragment_mask)[i] == 0) { continue; }
-
-							const Color texel = (tex) ? tex->GetColor(UPoint{ UInt(reinterpret_cast<const SInt*>(&u)[i]), UInt(reinterpret_cast<const SInt*>(&v)[i]) }) : Color{ 255, 255, 255, Color::Solid };
-							const Color lumel = Color{
-								Byte(reinterpret_cast<const SInt*>(&wlumel.r)[i]),
-								Byte(reinterpret_cast<const SInt*>(&wlumel.g)[i]),
-								Byte(reinterpret_cast<const SInt*>(&wlumel.b)[i]),
-								Byte(reinterpret_cast<const SInt*>(&wlumel.blend)[i])
-							};
-
-							const UPoint pt = UPoint{ UInt(reinterpret_cast<SInt*>(&q.x)[i]), UInt(reinterpret_cast<SInt*>(&q.y)[i]) };
-							switch (texel.blend)
-							{
-							case Color::Solid:
-								dst.SetColor(pt, Dither2x2(texel * lumel, pt));
-								if (zw) { zw[i] = reinterpret_cast<const float*>(&sz)[i]; }
-								break;
-							case Color::AddAlpha:
-								dst.SetColor(pt, Dither2x2(dst.GetColor(pt) + texel * lumel, pt));
-								break;
-							case Color::Emissive:
-								dst.SetColor(pt, texel);
-								if (zw) { zw[i] = reinterpret_cast<const float*>(&sz)[i]; }
-								break;
-							case Color::EmissiveAddAlpha:
-								dst.SetColor(pt, Dither2x2(dst.GetColor(pt) + texel, pt));
-								break;
-							default: break;
-							}
-						}
+		const SpanBuffer::Span covered = ClipScanline(w_y, w_x_inc, min_x, max_x);
+		TINY3D_STATS_ADD(fragments_covered, covered.a < covered.b ? covered.b - covered.a : 0);
+
+		if (covered.a < covered.b && !spans.IsCovered(UInt(y))) {
+
+			const UInt ngaps = spans.GetUncovered(UInt(y), covered);
+			TINY3D_STATS_ADD(fragments_depth_rejected, covered.b - covered.a - CountGapPixels(spans, ngaps));
+
+			for (UInt i = 0; i < ngaps; ++i) {
+
+				const SpanBuffer::Span gap = spans.GetGap(i);
+
+				// barycentric coordinates are computed from the unbiased edge functions at the start of each gap
+				const SXInt dx = SInt(gap.a) - min_x;
+				float       l0 = SInt(w_y[0] - bias[0] + w_x_inc[0] * dx) * inv_area_x2;
+				float       l1 = SInt(w_y[1] - bias[1] + w_x_inc[1] * dx) * inv_area_x2;
+				float       l2 = SInt(w_y[2] - bias[2] + w_x_inc[2] * dx) * inv_area_x2;
+				UInt        run = gap.a; // the start of the current run of opaque fragments
+
+				for (UInt x = gap.a; x < gap.b; ++x) {
+					const UPoint q     = { x, UInt(y) };
+					const Color  pixel = dst.GetColor(q);
+					TINY3D_STATS_ADD(fragments_stencil_rejected, pixel.blend == Color::Transparent ? 1 : 0);
+					if (pixel.blend == Color::Transparent || !shader(q, pixel, l0, l1, l2)) { // use transparency bit as a 1-bit stencil
+						spans.Cover(UInt(y), SpanBuffer::Span{ run, x });
+						run = x + 1;
 					}
+					l0 += w_x_inc[0] * inv_area_x2;
+					l1 += w_x_inc[1] * inv_area_x2;
+					l2 += w_x_inc[2] * inv_area_x2;
 				}
+				spans.Cover(UInt(y), SpanBuffer::Span{ run, gap.b });
 			}
+		} else {
+			TINY3D_STATS_ADD(fragments_depth_rejected, covered.a < covered.b ? covered.b - covered.a : 0);
+		}
 
-			w0 += w0_x_inc;
-			w1 += w1_x_inc;
-			w2 += w2_x_inc;
+		for (int i = 0; i < 3; ++i) {
+			w_y[i] += w_y_inc[i];
+		}
+	}
+}
 
-			l0 += l0_x_inc;
-			l1 += l1_x_inc;
-			l2 += l2_x_inc;
+void tiny3d::DrawTriangle(tiny3d::Image &dst, tiny3d::SpanBuffer &spans, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	const SXInt area_x2 = DetermineHalfspace(ScreenPoint(b), ScreenPoint(c), ScreenPoint(a));
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const internal_impl::IVertex ia = ToI(a, tex);
+	const internal_impl::IVertex ib = ToI(area_x2 > 0 ? b : c, tex);
+	const internal_impl::IVertex ic = ToI(area_x2 > 0 ? c : b, tex);
+	const ColorShader_Span shader = { dst, ia, ib, ic, tex };
+	RasterizeTriangle_Span(dst, spans, ia, ib, ic, dst_rect, shader);
+}
+
+void tiny3d::DrawTriangle(tiny3d::Image &dst, tiny3d::SpanBuffer &spans, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	TINY3D_STATS_ADD(triangles_submitted, 1);
+	const SXInt area_x2 = DetermineHalfspace(ScreenPoint(b), ScreenPoint(c), ScreenPoint(a));
+	if (IsCulled(area_x2, cull_mode)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	const internal_impl::ILVertex ia = ToI(a, tex, lightmap);
+	const internal_impl::ILVertex ib = ToI(area_x2 > 0 ? b : c, tex, lightmap);
+	const internal_impl::ILVertex ic = ToI(area_x2 > 0 ? c : b, tex, lightmap);
+	const LightmapShader_Span shader = { dst, ia, ib, ic, tex, lightmap };
+	RasterizeTriangle_Span(dst, spans, ia, ib, ic, dst_rect, shader);
+}
 
-			q.x += SIMD_X_TILE;
+// @data VertexCache
+// @info A post-transform cache for indexed triangle batches. Converts a vertex to its internal representation when it is referenced, and keeps the most recent conversions in a small direct-mapped table keyed by a hash of the index, so vertices shared by nearby triangles are only converted once. Its size does not depend on the number of vertices in the batch.
+template < typename vert_t, typename ivert_t >
+class VertexCache
+{
+private:
+	static constexpr tiny3d::UInt SIZE_BITS = 6;
+	static constexpr tiny3d::UInt SIZE      = 1 << SIZE_BITS;
+	static constexpr tiny3d::UInt EMPTY     = 0xffffffff;
+
+private:
+	ivert_t                m_verts[SIZE];
+	tiny3d::UInt           m_tags[SIZE];
+	const vert_t          *m_src;
+	const tiny3d::Texture *m_tex;
+	const tiny3d::Texture *m_lightmap;
+
+private:
+	ivert_t Convert(const tiny3d::Vertex &v) const  { return ToI(v, m_tex); }
+	ivert_t Convert(const tiny3d::LVertex &v) const { return ToI(v, m_tex, *m_lightmap); }
+
+public:
+	VertexCache(const vert_t *verts, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap) : m_src(verts), m_tex(tex), m_lightmap(lightmap)
+	{
+		for (tiny3d::UInt i = 0; i < SIZE; ++i) { m_tags[i] = EMPTY; }
+	}
 
-			if (zr) { zr += SIMD_X_TILE; }
-			if (zw) { zw += SIMD_X_TILE; }
+	// @algo []
+	// @in i -> The index of the vertex.
+	// @out The converted vertex.
+	// @note Returns a copy, since looking up another index may evict the entry.
+	ivert_t operator[](tiny3d::UInt i)
+	{
+		const tiny3d::UInt slot = tiny3d::UInt(i * 2654435761u) >> (32 - SIZE_BITS); // Fibonacci hashing, so regular index patterns such as the rows of a grid do not map to the same entries
+		if (m_tags[slot] != i) {
+			m_verts[slot] = Convert(m_src[i]);
+			m_tags[slot]  = i;
 		}
+		return m_verts[slot];
+	}
+};
 
-		w0_y += w0_y_inc;
-		w1_y += w1_y_inc;
-		w2_y += w2_y_inc;
+// @algo DrawCachedTriangle
+// @info Draws a triangle made of converted vertices with either DrawTriangle or DrawTriangle_Fast. The triangle must already be culled and wound clockwise.
+template < bool fast, typename depth_t >
+void DrawCachedTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture*, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz)
+{
+	if (fast) { internal_impl::DrawTriangle_Fast(dst, zread, zwrite, a, b, c, tex, dst_rect, perspective, depth_format, hiz, CullMode_None); }
+	else      { internal_impl::DrawTriangle(dst, zread, zwrite, a, b, c, tex, dst_rect, depth_format, CullMode_None); }
+}
 
-		l0_y += l0_y_inc;
-		l1_y += l1_y_inc;
-		l2_y += l2_y_inc;
+template < bool fast, typename depth_t >
+void DrawCachedTriangle(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz)
+{
+	if (fast) { internal_impl::DrawTriangle_Fast(dst, zread, zwrite, a, b, c, tex, *lightmap, dst_rect, perspective, depth_format, hiz, CullMode_None); }
+	else      { internal_impl::DrawTriangle(dst, zread, zwrite, a, b, c, tex, *lightmap, dst_rect, depth_format, CullMode_None); }
+}
 
-		q.x = p.x;
-		q.y += SIMD_Y_TILE;
+// @data InternalVertex
+// @info The internal representation of a vertex type.
+template < typename vert_t > struct InternalVertex;
+template <> struct InternalVertex<tiny3d::Vertex>  { typedef internal_impl::IVertex  type; };
+template <> struct InternalVertex<tiny3d::LVertex> { typedef internal_impl::ILVertex type; };
 
-		if (zread_offset)  { zread_offset  += dst.GetWidth() * SIMD_Y_TILE; }
-		if (zwrite_offset) { zwrite_offset += dst.GetWidth() * SIMD_Y_TILE; }
+template < bool fast, typename depth_t, typename vert_t, typename index_t >
+void internal_impl::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t *verts, tiny3d::UInt nverts, const index_t *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	TINY3D_STATS_TIME(RenderStage_Setup);
+	VertexCache< vert_t, typename InternalVertex<vert_t>::type > cache(verts, tex, lightmap);
+	for (UInt i = 0; i < ntris * 3; i += 3) {
+		const UInt ia = UInt(indices[i]);
+		const UInt ib = UInt(indices[i + 1]);
+		const UInt ic = UInt(indices[i + 2]);
+		TINY3D_ASSERT(ia < nverts && ib < nverts && ic < nverts);
+
+		// cull before the vertices are converted, so vertices only referenced by culled triangles are never converted
+		const SXInt area_x2 = DetermineHalfspace(ScreenPoint(verts[ib]), ScreenPoint(verts[ic]), ScreenPoint(verts[ia]));
+		if (IsCulled(area_x2, cull_mode)) {
+			TINY3D_STATS_ADD(triangles_submitted, 1); // triangles that are not culled are counted by DrawTriangle and DrawTriangle_Fast
+			TINY3D_STATS_ADD(triangles_culled, 1);
+			continue;
+		}
+		const typename InternalVertex<vert_t>::type a = cache[ia];
+		const typename InternalVertex<vert_t>::type b = cache[ib];
+		const typename InternalVertex<vert_t>::type c = cache[ic];
+		if (area_x2 > 0) { DrawCachedTriangle<fast>(dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, perspective, depth_format, hiz); }
+		else             { DrawCachedTriangle<fast>(dst, zread, zwrite, a, c, b, tex, lightmap, dst_rect, perspective, depth_format, hiz); }
 	}
 }
 
-void tiny3d::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect)
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
 {
-	internal_impl::DrawTriangle_Fast(dst, zread, zwrite, ToI(a, tex, lightmap), ToI(b, tex, lightmap), ToI(c, tex, lightmap), tex, lightmap, dst_rect);
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, nullptr, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<false, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, nullptr, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true>(dst, zread, zwrite, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	internal_impl::DrawTriangles<true, float>(dst, nullptr, nullptr, verts, nverts, indices, ntris, tex, &lightmap, dst_rect, perspective, depth_format, nullptr, cull_mode);
 }
 
 template < typename src_t >
 void internal_impl::DrawRegion(tiny3d::Image &dst, tiny3d::Rect dst_region, const src_t &src, tiny3d::Rect src_region, const tiny3d::URect *dst_rect)
 {
+	TINY3D_STATS_TIME(RenderStage_Blit);
+
 	// TODO: u and v do not have to be unit scaled, which saves two multiplications and two int->float conversions per pixel.
 	// TODO: Change to fixed point rendering.
 	tiny3d::URect DstRect = (dst_rect != nullptr) ? *dst_rect : tiny3d::URect{ tiny3d::UPoint{ 0,0 }, tiny3d::UPoint{ dst.GetWidth(), dst.GetHeight() } };
@@ -1101,6 +1312,7 @@ tiny3d::Byte ExtractStencilBit(const tiny3d::Byte *stencil_bits, tiny3d::UInt nu
 
 tiny3d::Point internal_impl::DrawChars(tiny3d::Image &dst, tiny3d::Point p, const char *ch, tiny3d::UInt ch_num, tiny3d::Color color, tiny3d::UInt scale, const tiny3d::URect *dst_rect)
 {
+	TINY3D_STATS_TIME(RenderStage_Blit);
 	const SInt scaled_font_width = font_char_px_width * SInt(scale);
 	const Point out_p = { p.x + scaled_font_width * SInt(ch_num), p.y  };
 	if (scale == 0 || ch_num == 0) { return out_p; }
@@ -6,6 +6,8 @@
 #include "tiny_texture.h"
 #include "tiny_structs.h"
 #include "tiny_overlay.h"
+#include "tiny_hiz.h"
+#include "tiny_span.h"
 
 // @data TINY3D_CHAR_WIDTH
 // @info The width in pixels of a character in the built-in system font.
@@ -28,54 +30,151 @@ namespace tiny3d
 // @algo DrawPoint
 // @info Draws a single pixel point on the destination buffer.
 // @in
-//   zread -> The depth buffer used to determine visibility. NULL to disable depth read.
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
 //   a -> The vertex to render.
 //   tex -> The texture to use for rendering. NULL for untextured.
 //   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
 // @inout
 //   dst -> The destination color buffer to draw a point to.
 //   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
-void DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr);
+void DrawPoint(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+void DrawPoint(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+void DrawPoint(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
 
 
 // @algo DrawLine
 // @info Draws a single pixel width line on the destination buffer.
 // @in
-//   zread -> The depth buffer used to determine visibility. NULL to disable depth read.
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
 //   a, b -> The vertices defining the line segment to render.
 //   tex -> The texture to use for rendering. NULL for untextured.
-//   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds, without moving the pixels of the line inside of them. NULL for full screen.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
 // @inout
 //   dst -> The destination color buffer to draw a point to.
 //   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
-void DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr);
+void DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+void DrawLine(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+void DrawLine(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
 
 // @algo DrawTriangle
 // @info Draws a triangle on the destination buffer.
 // @in
-//   zread -> The depth buffer used to determine visibility. NULL to disable depth read.
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
 //   a, b, c -> The vertices defining the triangle to render.
 //   tex -> The texture to use for rendering. NULL for untextured.
 //   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   perspective -> How texture coordinates and colors are corrected for perspective (DrawTriangle_Fast only). DrawTriangle always corrects per pixel.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
+//   cull_mode -> Which triangles to discard by the order of their vertices on screen. Zero area triangles are always discarded. See tiny3d::CullMode.
 // @inout
 //   dst -> The destination color buffer to draw a point to.
 //   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
-void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr);
-void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr);
+//   hiz -> The coarse depth buffer of zread used to reject hidden triangles and blocks early, and updated when zwrite is zread (DrawTriangle_Fast only). NULL to disable. See tiny3d::HiZBuffer.
+void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
 
 // @algo DrawTriangle
 // @info Draws a lightmap shaded triangle to the destination buffer.
 // @in
-//   zread -> The depth buffer used to determine visibility. NULL to disable depth read.
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
+//   a, b, c -> The vertices defining the triangle to render.
+//   tex -> The texture to use for rendering. NULL for untextured.
+//   lightmap -> The non-optional light map used for shading the triangle.
+//   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   perspective -> How texture coordinates and colors are corrected for perspective (DrawTriangle_Fast only). DrawTriangle always corrects per pixel.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
+//   cull_mode -> Which triangles to discard by the order of their vertices on screen. Zero area triangles are always discarded. See tiny3d::CullMode.
+// @inout
+//   dst -> The destination color buffer to draw a point to.
+//   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
+//   hiz -> The coarse depth buffer of zread used to reject hidden triangles and blocks early, and updated when zwrite is zread (DrawTriangle_Fast only). NULL to disable. See tiny3d::HiZBuffer.
+void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+
+// @algo DrawTriangle
+// @info Draws a triangle on the destination buffer using a span buffer instead of depth buffers for hidden surface removal. Triangles must be drawn front to back. Pixels covered by previously drawn opaque fragments are neither shaded nor written, so every pixel is shaded once.
+// @in
 //   a, b, c -> The vertices defining the triangle to render.
 //   tex -> The texture to use for rendering. NULL for untextured.
 //   lightmap -> The non-optional light map used for shading the triangle.
 //   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   cull_mode -> Which triangles to discard by the order of their vertices on screen. Zero area triangles are always discarded. See tiny3d::CullMode.
 // @inout
 //   dst -> The destination color buffer to draw a point to.
+//   spans -> The span buffer holding the pixels covered so far. Opaque fragments are added to it. See tiny3d::SpanBuffer.
+void DrawTriangle(tiny3d::Image &dst, tiny3d::SpanBuffer &spans, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangle(tiny3d::Image &dst, tiny3d::SpanBuffer &spans, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+
+// @algo DrawTriangles
+// @info Draws a batch of indexed triangles on the destination buffer. The most recently converted vertices are cached by index, so a vertex shared by nearby triangles is converted once, and the triangles are drawn in order as if by DrawTriangle or DrawTriangle_Fast.
+// @in
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
+//   verts -> The vertices referenced by the triangles.
+//   nverts -> The number of vertices.
+//   indices -> Three indices into verts per triangle, either 16-bit or 32-bit.
+//   ntris -> The number of triangles.
+//   tex -> The texture to use for rendering. NULL for untextured.
+//   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   perspective -> How texture coordinates and colors are corrected for perspective (DrawTriangles_Fast only). DrawTriangles always corrects per pixel.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
+//   cull_mode -> Which triangles to discard by the order of their vertices on screen. Zero area triangles are always discarded. See tiny3d::CullMode.
+// @inout
+//   dst -> The destination color buffer to draw to.
+//   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
+//   hiz -> The coarse depth buffer of zread used to reject hidden triangles and blocks early, and updated when zwrite is zread (DrawTriangles_Fast only). NULL to disable. See tiny3d::HiZBuffer.
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+
+// @algo DrawTriangles
+// @info Draws a batch of indexed lightmap shaded triangles on the destination buffer. The most recently converted vertices are cached by index, so a vertex shared by nearby triangles is converted once, and the triangles are drawn in order as if by DrawTriangle or DrawTriangle_Fast.
+// @in
+//   zread -> The depth buffer used to determine visibility. NULL to disable depth read. Either 32-bit floating point or 16-bit fixed point, see tiny3d::DepthFormat.
+//   verts -> The vertices referenced by the triangles.
+//   nverts -> The number of vertices.
+//   indices -> Three indices into verts per triangle, either 16-bit or 32-bit.
+//   ntris -> The number of triangles.
+//   tex -> The texture to use for rendering. NULL for untextured.
+//   lightmap -> The non-optional light map used for shading the triangles.
+//   dst_rect -> The mask rectangle. Discards rendering outside of the given bounds. NULL for full screen.
+//   perspective -> How texture coordinates and colors are corrected for perspective (DrawTriangles_Fast only). DrawTriangles always corrects per pixel.
+//   depth_format -> The format of the values in the depth buffers. See tiny3d::DepthFormat.
+//   cull_mode -> Which triangles to discard by the order of their vertices on screen. Zero area triangles are always discarded. See tiny3d::CullMode.
+// @inout
+//   dst -> The destination color buffer to draw to.
 //   zwrite -> The depth buffer to store depth information in. NULL to disable depth write.
-void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr);
-void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr);
+//   hiz -> The coarse depth buffer of zread used to reject hidden triangles and blocks early, and updated when zwrite is zread (DrawTriangles_Fast only). NULL to disable. See tiny3d::HiZBuffer.
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UHInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+void DrawTriangles_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex *verts, tiny3d::UInt nverts, const tiny3d::UInt *indices, tiny3d::UInt ntris, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
 
 // @algo DrawRegion
 // @info Transfers a source region to a destination region. Rescales source region to fit destination region.
@@ -0,0 +1,109 @@
+#include <limits>
+#include "tiny_hiz.h"
+
+using namespace tiny3d;
+
+template < typename depth_t >
+void tiny3d::HiZBuffer::UpdateTiles(const tiny3d::Array<depth_t> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format)
+{
+	TINY3D_ASSERT(depth.GetSize() == m_width * m_height);
+	const URect srect = Clip(rect, URect{ { 0, 0 }, { m_width, m_height } });
+	// a tile at the right or bottom edge of the buffer counts as inside if it is only clipped by the edge
+	const UInt min_tx = (srect.a.x + TileSize() - 1) / TileSize();
+	const UInt min_ty = (srect.a.y + TileSize() - 1) / TileSize();
+	const UInt max_tx = (srect.b.x == m_width)  ? m_tiles_x : srect.b.x / TileSize();
+	const UInt max_ty = (srect.b.y == m_height) ? m_tiles_y : srect.b.y / TileSize();
+	for (UInt ty = min_ty; ty < max_ty; ++ty) {
+		const UInt min_y = ty * TileSize();
+		const UInt max_y = tiny3d::Min(min_y + TileSize(), m_height);
+		for (UInt tx = min_tx; tx < max_tx; ++tx) {
+			const UInt min_x = tx * TileSize();
+			const UInt max_x = tiny3d::Min(min_x + TileSize(), m_width);
+			depth_t farthest = depth[min_x + min_y * m_width];
+			for (UInt y = min_y; y < max_y; ++y) {
+				const UInt row = y * m_width;
+				if (depth_format == DepthFormat_InvZ) {
+					for (UInt x = min_x; x < max_x; ++x) { farthest = tiny3d::Min(farthest, depth[row + x]); }
+				} else {
+					for (UInt x = min_x; x < max_x; ++x) { farthest = tiny3d::Max(farthest, depth[row + x]); }
+				}
+			}
+			m_farthest[tx + ty * m_tiles_x] = float(farthest);
+		}
+	}
+}
+
+tiny3d::HiZBuffer::HiZBuffer( void ) : m_farthest(), m_width(0), m_height(0), m_tiles_x(0), m_tiles_y(0)
+{}
+
+tiny3d::HiZBuffer::HiZBuffer(tiny3d::UInt width, tiny3d::UInt height) : HiZBuffer()
+{
+	Create(width, height);
+}
+
+void tiny3d::HiZBuffer::Create(tiny3d::UInt width, tiny3d::UInt height)
+{
+	m_width   = width;
+	m_height  = height;
+	m_tiles_x = (width + TileSize() - 1) / TileSize();
+	m_tiles_y = (height + TileSize() - 1) / TileSize();
+	m_farthest.Create(m_tiles_x * m_tiles_y);
+}
+
+void tiny3d::HiZBuffer::Destroy( void )
+{
+	m_farthest.Destroy();
+	m_width   = 0;
+	m_height  = 0;
+	m_tiles_x = 0;
+	m_tiles_y = 0;
+}
+
+void tiny3d::HiZBuffer::Clear(tiny3d::DepthFormat depth_format)
+{
+	const float farthest = (depth_format == DepthFormat_InvZ) ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+	for (UInt i = 0; i < m_farthest.GetSize(); ++i) {
+		m_farthest[i] = farthest;
+	}
+}
+
+void tiny3d::HiZBuffer::Update(const tiny3d::Array<float> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format)
+{
+	UpdateTiles(depth, rect, depth_format);
+}
+
+void tiny3d::HiZBuffer::Update(const tiny3d::Array<tiny3d::UHInt> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format)
+{
+	UpdateTiles(depth, rect, depth_format);
+}
+
+void tiny3d::HiZBuffer::Tighten(tiny3d::UInt x, tiny3d::UInt y, float farthest, tiny3d::DepthFormat depth_format)
+{
+	float &tile = m_farthest[x + y * m_tiles_x];
+	tile = (depth_format == DepthFormat_InvZ) ? tiny3d::Max(tile, farthest) : tiny3d::Min(tile, farthest);
+}
+
+float tiny3d::HiZBuffer::GetFarthest(tiny3d::UInt x, tiny3d::UInt y) const
+{
+	return m_farthest[x + y * m_tiles_x];
+}
+
+tiny3d::UInt tiny3d::HiZBuffer::GetTilesX( void ) const
+{
+	return m_tiles_x;
+}
+
+tiny3d::UInt tiny3d::HiZBuffer::GetTilesY( void ) const
+{
+	return m_tiles_y;
+}
+
+tiny3d::UInt tiny3d::HiZBuffer::GetWidth( void ) const
+{
+	return m_width;
+}
+
+tiny3d::UInt tiny3d::HiZBuffer::GetHeight( void ) const
+{
+	return m_height;
+}
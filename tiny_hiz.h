@@ -0,0 +1,90 @@
+#ifndef TINY_HIZ_H
+#define TINY_HIZ_H
+
+#include "tiny_system.h"
+#include "tiny_math.h"
+#include "tiny_structs.h"
+
+namespace tiny3d
+{
+
+// @data HiZBuffer
+// @info A coarse depth buffer holding the farthest depth value of each 8x8 pixel tile of a depth buffer. DrawTriangle_Fast uses it to reject whole triangles and blocks of pixels that are behind the depth buffer before doing any per-pixel work.
+// @note A coarse depth buffer belongs to the one depth buffer it is passed together with as zread. Its values are conservative, since drawing with depth read only ever moves depth nearer, so they are still valid after drawing to the depth buffer with other functions. Clear it whenever the depth buffer is cleared or written to without depth read.
+class HiZBuffer
+{
+private:
+	tiny3d::Array<float> m_farthest;
+	tiny3d::UInt         m_width;   // in pixels
+	tiny3d::UInt         m_height;  // in pixels
+	tiny3d::UInt         m_tiles_x;
+	tiny3d::UInt         m_tiles_y;
+
+private:
+	template < typename depth_t >
+	void UpdateTiles(const tiny3d::Array<depth_t> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format);
+
+public:
+	HiZBuffer( void );
+	HiZBuffer(tiny3d::UInt width, tiny3d::UInt height);
+
+	// @algo Create
+	// @info Creates a coarse depth buffer for a depth buffer with the given dimensions. The contents are undefined until cleared.
+	// @in width, height -> The dimensions in pixels of the depth buffer.
+	void Create(tiny3d::UInt width, tiny3d::UInt height);
+
+	// @algo Destroy
+	// @info Frees resources used by the coarse depth buffer.
+	void Destroy( void );
+
+	// @algo Clear
+	// @info Marks all tiles as possibly containing the farthest possible depth, so nothing is rejected until tiles are updated.
+	// @in depth_format -> The format of the depth buffer.
+	void Clear(tiny3d::DepthFormat depth_format);
+
+	// @algo Update
+	// @info Recomputes the farthest depth of the tiles located entirely inside of a rectangle from the depth buffer.
+	// @in
+	//   depth -> The depth buffer.
+	//   rect -> The rectangle. Tiles only partially inside of the rectangle are not touched, so threads working on non-overlapping rectangles can update the same coarse depth buffer.
+	//   depth_format -> The format of the depth buffer.
+	void Update(const tiny3d::Array<float> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format);
+	void Update(const tiny3d::Array<tiny3d::UHInt> &depth, tiny3d::URect rect, tiny3d::DepthFormat depth_format);
+
+	// @algo Tighten
+	// @info Moves the farthest depth of a tile nearer without reading the depth buffer, for callers that know a bound of every depth value in the tile, e.g. after drawing a triangle covering the entire tile.
+	// @in
+	//   x, y -> The tile coordinate.
+	//   farthest -> The bound of the depth values in the tile, in the units of the depth buffer. Ignored if farther than the current value.
+	//   depth_format -> The format of the depth buffer.
+	void Tighten(tiny3d::UInt x, tiny3d::UInt y, float farthest, tiny3d::DepthFormat depth_format);
+
+	// @algo GetFarthest
+	// @in x, y -> The tile coordinate.
+	// @out The farthest depth value in the tile, in the units of the depth buffer.
+	float GetFarthest(tiny3d::UInt x, tiny3d::UInt y) const;
+
+	// @algo GetTilesX
+	// @out The number of tiles along the horizontal axis.
+	tiny3d::UInt GetTilesX( void ) const;
+
+	// @algo GetTilesY
+	// @out The number of tiles along the vertical axis.
+	tiny3d::UInt GetTilesY( void ) const;
+
+	// @algo GetWidth
+	// @out The width in pixels of the depth buffer.
+	tiny3d::UInt GetWidth( void ) const;
+
+	// @algo GetHeight
+	// @out The height in pixels of the depth buffer.
+	tiny3d::UInt GetHeight( void ) const;
+
+	// @algo TileSize
+	// @out The width and height in pixels of a tile.
+	static constexpr tiny3d::UInt TileSize( void ) { return 8; }
+};
+
+}
+
+#endif // TINY_HIZ_H
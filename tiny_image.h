@@ -5,6 +5,8 @@
 #include "tiny_math.h"
 #include "tiny_structs.h"
 
+namespace internal_impl { struct SurfaceAccess; }
+
 namespace tiny3d
 {
 
@@ -13,6 +15,8 @@ namespace tiny3d
 class Image
 {
 private:
+	friend struct ::internal_impl::SurfaceAccess; // the SIMD fragment loads and stores of tiny_raster_fast.h
+
 	tiny3d::UHInt *m_pixels;
 	tiny3d::UInt   m_width;
 	tiny3d::UInt   m_height;
@@ -1386,6 +1386,17 @@ tiny3d::Matrix4x4 tiny3d::Inv(const tiny3d::Matrix4x4 &m)
 	return i;
 }
 
+tiny3d::Matrix4x4 tiny3d::Perspective(tiny3d::Real fov, tiny3d::Real aspect, tiny3d::Real z_near, tiny3d::Real z_far)
+{
+	const Real f = Real(1) / tanf(fov * Real(0.5));
+	return Matrix4x4(
+		f / aspect, Real(0), Real(0),                                  Real(0),
+		Real(0),    f,       Real(0),                                  Real(0),
+		Real(0),    Real(0), (z_far + z_near) / (z_far - z_near),      Real(-2) * z_far * z_near / (z_far - z_near),
+		Real(0),    Real(0), Real(1),                                  Real(0)
+	);
+}
+
 tiny3d::Vector3 tiny3d::operator*(const tiny3d::Vector3 &r, const Matrix4x4 &l)
 {
 	return Vector3(
@@ -168,6 +168,19 @@ bool TestBit(int_t bits, tiny3d::UInt i) { return (bits & (1 << i)) != 0; }
 template < typename int_t >
 int_t ReadBit(int_t bits, tiny3d::UInt i) { return (bits >> i) & 1; }
 
+// @algo CountBits
+// @info Counts the bits set to 1.
+// @in
+//   bits -> The bit pattern to count.
+// @out The number of bits set to 1.
+template < typename int_t >
+tiny3d::UInt CountBits(int_t bits)
+{
+	tiny3d::UInt n = 0;
+	for (; bits != 0; bits &= bits - 1) { ++n; }
+	return n;
+}
+
 /*class XReal;
 
 // if 1 unit = 1 meter, where standard 16 gives us a range of -16 - 16 kms (32 km) with a precision of 1/65 mm
@@ -743,6 +756,15 @@ Vector3   Translation(const Matrix4x4 &transform);
 // @out The invertex matrix.
 Matrix4x4 Inv(const Matrix4x4 &m);
 
+// @algo Perspective
+// @info Constructs a perspective projection for a view looking down the positive z axis. Maps the near plane to -1 and the far plane to 1 in clip space z and stores the view depth in clip space w. See tiny3d::ProjectVertices.
+// @in
+//   fov -> The vertical field of view in radians.
+//   aspect -> The width of the view divided by its height.
+//   z_near, z_far -> The distances to the near and far planes.
+// @out The projection matrix.
+Matrix4x4 Perspective(Real fov, Real aspect, Real z_near, Real z_far);
+
 Vector3 operator*(const Vector3 &l, const Matrix4x4 &r);
 
 }
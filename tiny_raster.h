@@ -0,0 +1,259 @@
+#ifndef TINY_RASTER_H
+#define TINY_RASTER_H
+
+#include "tiny_draw.h"
+#include "tiny_math.h"
+#include "tiny_simd.h"
+#include "tiny_stats.h"
+
+// NOTE: Internal to tiny_draw.cpp, tiny_tile.cpp and the SIMD backends of the _Fast functions in tiny_raster_fast.h.
+
+namespace internal_impl
+{
+	struct IVertex
+	{
+		tiny3d::Point p;
+		float u, v;    // 1/tcoord (non-normalized)
+		float r, g, b; // 1/color
+		float w;       // 1/z
+	};
+
+	inline IVertex operator+(IVertex a, IVertex b) { return IVertex{ { a.p.x + b.p.x, a.p.y + b.p.y }, a.u + b.u, a.v + b.v, a.r + b.r, a.g + b.g, a.b + b.b, a.w + b.w }; }
+	inline IVertex operator-(IVertex a, IVertex b) { return IVertex{ { a.p.x - b.p.x, a.p.y - b.p.y }, a.u - b.u, a.v - b.v, a.r - b.r, a.g - b.g, a.b - b.b, a.w - b.w }; }
+	inline IVertex operator*(IVertex a, tiny3d::Real b) { return IVertex{ { tiny3d::SInt(a.p.x * b), tiny3d::SInt(a.p.y * b) }, a.u * b, a.v * b, a.r * b, a.g * b, a.b * b, a.w * b }; }
+
+	struct ILVertex
+	{
+		tiny3d::Point p;
+		float u, v;   // 1/tcoord (non-normalized)
+		float lu, lv; // 1/lcoord (non-normalized)
+		float w;      // 1/z
+	};
+
+	// @data SurfaceAccess
+	// @info Exposes the storage of images and textures to the SIMD backends in tiny_raster_fast.h. The wide types differ between backends, so the fragment loads and stores are free functions in the namespace of each backend rather than members of Image and Texture.
+	struct SurfaceAccess
+	{
+		typedef tiny3d::Texture::CCCBlock CCCBlock;
+		static constexpr tiny3d::UInt CCC_DIM_MASK  = tiny3d::Texture::CCC_DIM_MASK;
+		static constexpr tiny3d::UInt CCC_DIM_SHIFT = tiny3d::Texture::CCC_DIM_SHIFT;
+
+		static tiny3d::UHInt       *GetPixels(tiny3d::Image &img)                { return img.m_pixels; }
+		static const tiny3d::UHInt *GetPixels(const tiny3d::Image &img)          { return img.m_pixels; }
+		static tiny3d::UInt         GetWidth(const tiny3d::Image &img)           { return img.m_width; }
+		static tiny3d::UInt         GetHeight(const tiny3d::Image &img)          { return img.m_height; }
+		static const CCCBlock      *GetBlocks(const tiny3d::Texture &tex)        { return tex.m_texels; }
+		static tiny3d::UInt         GetBlockCount(const tiny3d::Texture &tex)    { return tex.m_blocks * tex.m_blocks; }
+		static tiny3d::UInt         GetDimensionMask(const tiny3d::Texture &tex) { return tex.m_dim_mask; }
+	};
+
+	// @data FastPipelines
+	// @info The table of specialized pipelines of a SIMD backend of DrawTriangle_Fast, indexed by PipelineKey_Fast. The pipelines expect clockwise triangles that have passed culling.
+	template < typename depth_t >
+	struct FastPipelines
+	{
+		typedef void (*ColorPipeline)(tiny3d::Image&, const tiny3d::Array<depth_t>*, tiny3d::Array<depth_t>*, const internal_impl::IVertex&, const internal_impl::IVertex&, const internal_impl::IVertex&, const tiny3d::Texture*, const tiny3d::URect*, tiny3d::PerspectiveMode, tiny3d::DepthFormat, tiny3d::HiZBuffer*);
+		typedef void (*LightmapPipeline)(tiny3d::Image&, const tiny3d::Array<depth_t>*, tiny3d::Array<depth_t>*, const internal_impl::ILVertex&, const internal_impl::ILVertex&, const internal_impl::ILVertex&, const tiny3d::Texture*, const tiny3d::Texture&, const tiny3d::URect*, tiny3d::PerspectiveMode, tiny3d::DepthFormat, tiny3d::HiZBuffer*);
+
+		ColorPipeline    color[16];
+		LightmapPipeline lightmap[16];
+	};
+
+	// @algo GetFastPipelines
+	// @out The pipelines of a SIMD backend, defined in the namespace of the backend by tiny_raster_fast.h.
+#if TINY_SIMD_DISPATCH
+	namespace simd_sse    { template < typename depth_t > const internal_impl::FastPipelines<depth_t> &GetFastPipelines( void ); }
+	namespace simd_avx2   { template < typename depth_t > const internal_impl::FastPipelines<depth_t> &GetFastPipelines( void ); }
+	namespace simd_avx512 { template < typename depth_t > const internal_impl::FastPipelines<depth_t> &GetFastPipelines( void ); }
+#else
+	namespace TINY_SIMD_NAMESPACE { template < typename depth_t > const internal_impl::FastPipelines<depth_t> &GetFastPipelines( void ); }
+#endif
+}
+
+// @algo Depth16Scale
+// @in depth_format -> The depth format.
+// @out The scale that converts a depth value to the fixed point representation of a 16-bit depth buffer. See tiny3d::DepthFormat.
+constexpr float Depth16Scale(tiny3d::DepthFormat depth_format)
+{
+	return depth_format == tiny3d::DepthFormat_InvZ ? 65536.0f : 256.0f;
+}
+
+// @algo EncodeDepth
+// @info Converts a depth value to the representation stored in a depth buffer with the given element type. 16-bit depth saturates at the ends of its range.
+// @in
+//   depth -> The depth value in the given format.
+//   depth_format -> The format of the depth buffer.
+// @out The value to store in the depth buffer.
+template < typename depth_t >
+depth_t EncodeDepth(float depth, tiny3d::DepthFormat depth_format);
+
+template <>
+inline float EncodeDepth<float>(float depth, tiny3d::DepthFormat)
+{
+	return depth;
+}
+
+template <>
+inline tiny3d::UHInt EncodeDepth<tiny3d::UHInt>(float depth, tiny3d::DepthFormat depth_format)
+{
+	return tiny3d::UHInt(tiny3d::Clamp(0.0f, depth * Depth16Scale(depth_format), 65535.0f));
+}
+
+// @algo DepthTest
+// @info Tests a depth value against the value stored in the depth buffer.
+// @in
+//   depth -> The depth value of the fragment in the format of the depth buffer.
+//   stored -> The value stored in the depth buffer.
+//   depth_format -> The format of the depth buffer.
+// @out TRUE if the fragment is visible.
+template < typename depth_t >
+bool DepthTest(depth_t depth, depth_t stored, tiny3d::DepthFormat depth_format)
+{
+	return depth_format == tiny3d::DepthFormat_InvZ ? depth >= stored : depth <= stored;
+}
+
+inline tiny3d::SXInt DetermineHalfspace(tiny3d::Point a, tiny3d::Point b, tiny3d::Point point)
+{
+	return tiny3d::SXInt(b.x - a.x) * tiny3d::SXInt(point.y - a.y) - tiny3d::SXInt(b.y - a.y) * tiny3d::SXInt(point.x - a.x);
+}
+
+inline bool IsTopLeft(tiny3d::Point a, tiny3d::Point b)
+{
+	// strictly connected to winding order
+	return (a.x < b.x && b.y == a.y) || (a.y > b.y);
+}
+
+// @algo IsCulled
+// @info Applies a cull mode to a triangle. The rasterizers only draw clockwise triangles, so counter-clockwise triangles that are not culled must be drawn with two of their vertices swapped. Shared by the Draw functions and TileRenderer, which culls before recording.
+// @in
+//   area_x2 -> The doubled signed area of the triangle on screen, DetermineHalfspace(b, c, a). Positive for clockwise triangles.
+//   cull_mode -> The cull mode.
+// @out TRUE if the triangle is discarded. Zero area triangles are always discarded.
+inline bool IsCulled(tiny3d::SXInt area_x2, tiny3d::CullMode cull_mode)
+{
+	return area_x2 == 0 || (area_x2 > 0 && cull_mode == tiny3d::CullMode_CW) || (area_x2 < 0 && cull_mode == tiny3d::CullMode_CCW);
+}
+
+// @algo ScreenPoint
+// @in v -> A vertex.
+// @out The pixel the vertex is located at, as computed by ToI.
+template < typename vert_t >
+tiny3d::Point ScreenPoint(const vert_t &v)
+{
+	return tiny3d::Point{ tiny3d::SInt(v.v.x), tiny3d::SInt(v.v.y) };
+}
+
+enum BlockCoverage
+{
+	Block_Outside,
+	Block_Partial,
+	Block_Inside
+};
+
+// @algo ClassifyBlock
+// @info Tests the corners of a rectangular block of pixels against the three edges of a triangle.
+// @in
+//   a, b, c -> The triangle.
+//   bias -> The fill convention offsets of the edges bc, ca and ab.
+//   min, max -> The inclusive corners of the block.
+// @out The coverage of the block.
+inline BlockCoverage ClassifyBlock(tiny3d::Point a, tiny3d::Point b, tiny3d::Point c, const tiny3d::SInt *bias, tiny3d::Point min, tiny3d::Point max)
+{
+	const tiny3d::Point corners[4]  = { min, { max.x, min.y }, { min.x, max.y }, max };
+	const tiny3d::Point edges[3][2] = { { b, c }, { c, a }, { a, b } };
+	bool inside = true;
+	for (int e = 0; e < 3; ++e) {
+		int n = 0;
+		for (int i = 0; i < 4; ++i) {
+			if (DetermineHalfspace(edges[e][0], edges[e][1], corners[i]) + bias[e] >= 0) { ++n; }
+		}
+		if (n == 0) { return Block_Outside; } // since the edge function is linear all pixels in the block are outside of the edge
+		inside = inside && (n == 4);
+	}
+	return inside ? Block_Inside : Block_Partial;
+}
+
+// @algo ClipScanline
+// @info Finds the pixels on a scanline that pass the coverage test of a triangle by solving the edge functions for x, instead of testing every pixel.
+// @in
+//   w -> The biased edge functions at the first pixel of the scanline.
+//   w_x_inc -> The change of the edge functions per pixel.
+//   min_x, max_x -> The inclusive range of pixels on the scanline to consider.
+// @out The covered span [a, b) of the scanline, empty if a >= b.
+inline tiny3d::SpanBuffer::Span ClipScanline(const tiny3d::SXInt *w, const tiny3d::SInt *w_x_inc, tiny3d::SInt min_x, tiny3d::SInt max_x)
+{
+	tiny3d::SXInt lo = 0;
+	tiny3d::SXInt hi = max_x - min_x;
+	for (int i = 0; i < 3; ++i) {
+		if (w_x_inc[i] > 0) {
+			if (w[i] < 0) { lo = tiny3d::Max(lo, (-w[i] + w_x_inc[i] - 1) / w_x_inc[i]); }
+		} else if (w_x_inc[i] < 0) {
+			if (w[i] < 0) { return tiny3d::SpanBuffer::Span{ 0, 0 }; }
+			hi = tiny3d::Min(hi, w[i] / -w_x_inc[i]);
+		} else if (w[i] < 0) {
+			return tiny3d::SpanBuffer::Span{ 0, 0 };
+		}
+	}
+	if (lo > hi) { return tiny3d::SpanBuffer::Span{ 0, 0 }; }
+	return tiny3d::SpanBuffer::Span{ tiny3d::UInt(min_x + lo), tiny3d::UInt(min_x + hi + 1) };
+}
+
+// @algo ScanlineRatio
+// @out The ratio between the area of the bounding box of a triangle and the area of the triangle above which the triangle is traversed one scanline at a time instead of testing every pixel in the bounding box.
+constexpr tiny3d::SInt ScanlineRatio( void )
+{
+	return 4;
+}
+
+// @algo PreferScanlines
+// @info Tests if most of the bounding box of a triangle is empty, as for long diagonal slivers, in which case finding the covered pixels of each scanline with ClipScanline is cheaper than testing every pixel in the bounding box.
+// @in
+//   area_x2 -> The doubled area of the triangle.
+//   min, max -> The inclusive clipped bounding box of the triangle.
+// @out TRUE if the triangle should be traversed one scanline at a time.
+inline bool PreferScanlines(tiny3d::SXInt area_x2, tiny3d::Point min, tiny3d::Point max)
+{
+	return tiny3d::SXInt(max.x - min.x + 1) * tiny3d::SXInt(max.y - min.y + 1) * 2 > area_x2 * ScanlineRatio();
+}
+
+// @algo BoundingBoxArea
+// @in min, max -> The inclusive clipped bounding box of a triangle.
+// @out The number of pixels in the bounding box, or zero if it is empty.
+inline tiny3d::UXInt BoundingBoxArea(tiny3d::Point min, tiny3d::Point max)
+{
+	return (max.x < min.x || max.y < min.y) ? 0 : tiny3d::UXInt(max.x - min.x + 1) * tiny3d::UXInt(max.y - min.y + 1);
+}
+
+// @data TexelBlend
+// @info The blend modes texels of a texture can take. Used to select the pipeline for a texture once per triangle, instead of per pixel.
+enum TexelBlend
+{
+	TexelBlend_None,     // untextured, shaded as if solid white
+	TexelBlend_Solid,    // Solid or Transparent
+	TexelBlend_Emissive, // Emissive or Transparent
+	TexelBlend_Any       // any combination of blend modes
+};
+
+// @algo GetTexelBlend
+// @in tex -> The texture. NULL for untextured.
+// @out The set of blend modes the texels of the texture can take.
+inline TexelBlend GetTexelBlend(const tiny3d::Texture *tex)
+{
+	if (tex == nullptr) { return TexelBlend_None; }
+	const tiny3d::Color::BlendMode m1 = tex->GetBlendMode1();
+	const tiny3d::Color::BlendMode m2 = tex->GetBlendMode2();
+	if ((m1 == tiny3d::Color::Solid    || m1 == tiny3d::Color::Transparent) && (m2 == tiny3d::Color::Solid    || m2 == tiny3d::Color::Transparent)) { return TexelBlend_Solid; }
+	if ((m1 == tiny3d::Color::Emissive || m1 == tiny3d::Color::Transparent) && (m2 == tiny3d::Color::Emissive || m2 == tiny3d::Color::Transparent)) { return TexelBlend_Emissive; }
+	return TexelBlend_Any;
+}
+
+// @algo PipelineKey_Fast
+// @info Packs the render state into an index into the table of specialized pipelines.
+// @out [0] = depth read, [1] = depth write, [2..3] = TexelBlend.
+template < typename depth_t >
+tiny3d::UInt PipelineKey_Fast(const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Texture *tex)
+{
+	return (zread != nullptr ? 1 : 0) | (zwrite != nullptr ? 2 : 0) | (tiny3d::UInt(GetTexelBlend(tex)) << 2);
+}
+
+#endif // TINY_RASTER_H
@@ -0,0 +1,7 @@
+// NOTE: Compiles the AVX-512 backend of the _Fast functions for runtime dispatch. See TINY_SIMD_DISPATCH.
+#define TINY_SIMD_TARGET TINY_SIMD_AVX512
+#include "tiny_simd.h"
+
+#if TINY_SIMD_DISPATCH
+	#include "tiny_raster_fast.h"
+#endif
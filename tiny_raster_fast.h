@@ -0,0 +1,1400 @@
+#ifndef TINY_RASTER_FAST_H
+#define TINY_RASTER_FAST_H
+
+// NOTE: The SIMD backend of the _Fast functions. Included once per instruction set by tiny_raster_*.cpp, each defining TINY_SIMD_TARGET first, and compiled into a namespace of its own. See TINY_SIMD_DISPATCH.
+
+#include "tiny_raster.h"
+
+
+TINY_SIMD_TARGET_BEGIN
+
+namespace internal_impl
+{
+namespace TINY_SIMD_NAMESPACE
+{
+
+tiny3d::WideSInt DetermineHalfspace_Fast(tiny3d::Point a, tiny3d::Point b, const tiny3d::WidePoint &point)
+{
+	return tiny3d::WideSInt(b.x - a.x) * (point.y - tiny3d::WideSInt(a.y)) - tiny3d::WideSInt(b.y - a.y) * (point.x - tiny3d::WideSInt(a.x));
+}
+
+
+// @data ColorLanes
+// @info The colors of the lanes of a WideColor, for shading that has to be done one lane at a time.
+struct ColorLanes
+{
+	int r[TINY_WIDTH], g[TINY_WIDTH], b[TINY_WIDTH], blend[TINY_WIDTH];
+
+	ColorLanes( void ) : r{ 0 }, g{ 0 }, b{ 0 }, blend{ 0 } {}
+
+	explicit ColorLanes(const tiny3d::WideColor &c)
+	{
+		c.r.to_scalar(r);
+		c.g.to_scalar(g);
+		c.b.to_scalar(b);
+		c.blend.to_scalar(blend);
+	}
+
+	tiny3d::Color operator[](int i) const { return tiny3d::Color{ tiny3d::Byte(r[i]), tiny3d::Byte(g[i]), tiny3d::Byte(b[i]), tiny3d::Byte(blend[i]) }; }
+
+	void Set(int i, tiny3d::Color c)
+	{
+		r[i]     = c.r;
+		g[i]     = c.g;
+		b[i]     = c.b;
+		blend[i] = c.blend;
+	}
+
+	tiny3d::WideColor ToWide( void ) const { return tiny3d::WideColor{ tiny3d::WideSInt(r), tiny3d::WideSInt(g), tiny3d::WideSInt(b), tiny3d::WideSInt(blend) }; }
+};
+
+// @algo FragmentOffset
+// @info Gets the offset of a lane in a SIMD fragment relative to the first lane of the fragment.
+// @in
+//   lane -> The lane index.
+//   width -> The width of the buffer the fragment is located in.
+// @out The offset of the lane in the buffer.
+tiny3d::UInt FragmentOffset(int lane, tiny3d::UInt width)
+{
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	return tiny3d::UInt(X_COORD_OFFSET[lane]) + tiny3d::UInt(Y_COORD_OFFSET[lane]) * width;
+}
+
+// @algo FragmentPoint
+// @info Gets the coordinate of a lane in a SIMD fragment.
+// @in
+//   p -> The coordinate of the first lane of the fragment.
+//   lane -> The lane index.
+// @out The coordinate of the lane.
+tiny3d::UPoint FragmentPoint(tiny3d::UPoint p, int lane)
+{
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	return tiny3d::UPoint{ p.x + tiny3d::UInt(X_COORD_OFFSET[lane]), p.y + tiny3d::UInt(Y_COORD_OFFSET[lane]) };
+}
+
+// @algo LoadDepth_Fast
+// @info Loads the depth values covered by a SIMD fragment. Fragments inside of the depth buffer are loaded one row at a time. Otherwise lanes outside of the fragment mask are not read, since they may be located outside of the depth buffer.
+// @in
+//   z -> The depth value of the first lane of the fragment.
+//   width -> The width of the depth buffer.
+//   inside -> TRUE if every lane of the fragment is inside of the depth buffer.
+//   fragment_mask -> The lanes to load.
+// @out The depth values.
+tiny3d::WideReal LoadDepth_Fast(const float *z, tiny3d::UInt width, bool inside, const tiny3d::WideBool &fragment_mask)
+{
+	float depth[TINY_WIDTH];
+	if (inside) {
+		for (tiny3d::UInt y = 0; y < TINY_BLOCK_Y; ++y) {
+			std::memcpy(depth + y * TINY_BLOCK_X, z + y * width, sizeof(float) * TINY_BLOCK_X);
+		}
+		return tiny3d::WideReal(depth);
+	}
+	const unsigned int lanes = fragment_mask.to_bits();
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+		depth[i] = tiny3d::TestBit(lanes, i) ? z[FragmentOffset(i, width)] : 0.0f;
+	}
+	return tiny3d::WideReal(depth);
+}
+
+// @algo LoadDepth_Fast
+// @info Loads the values of a 16-bit depth buffer covered by a SIMD fragment, zero extended to 32-bit lanes.
+tiny3d::WideSInt LoadDepth_Fast(const tiny3d::UHInt *z, tiny3d::UInt width, bool inside, const tiny3d::WideBool &fragment_mask)
+{
+	if (inside) {
+		tiny3d::UHInt depth[TINY_WIDTH];
+		for (tiny3d::UInt y = 0; y < TINY_BLOCK_Y; ++y) {
+			std::memcpy(depth + y * TINY_BLOCK_X, z + y * width, sizeof(tiny3d::UHInt) * TINY_BLOCK_X);
+		}
+		return tiny3d::WideSInt(depth);
+	}
+	int depth[TINY_WIDTH];
+	const unsigned int lanes = fragment_mask.to_bits();
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+		depth[i] = tiny3d::TestBit(lanes, i) ? int(z[FragmentOffset(i, width)]) : 0;
+	}
+	return tiny3d::WideSInt(depth);
+}
+
+// @data DepthBuffer_Fast
+// @info The SIMD representation of the values in a depth buffer with the given element type.
+template < typename depth_t >
+struct DepthBuffer_Fast;
+
+template <>
+struct DepthBuffer_Fast<float>
+{
+	typedef tiny3d::WideReal wide_t;
+	static tiny3d::WideReal Encode(const tiny3d::WideReal &depth, tiny3d::DepthFormat) { return depth; }
+};
+
+template <>
+struct DepthBuffer_Fast<tiny3d::UHInt>
+{
+	typedef tiny3d::WideSInt wide_t;
+
+	// @algo Encode
+	// @info Converts depth values the same way as EncodeDepth.
+	static tiny3d::WideSInt Encode(const tiny3d::WideReal &depth, tiny3d::DepthFormat depth_format)
+	{
+		return tiny3d::WideSInt(tiny3d::WideReal::min(tiny3d::WideReal::max(depth * Depth16Scale(depth_format), tiny3d::WideReal(0.0f)), tiny3d::WideReal(65535.0f)));
+	}
+};
+
+// @algo DepthTest_Fast
+// @info Tests the depth values of a SIMD fragment the same way as DepthTest.
+template < typename wide_t >
+tiny3d::WideBool DepthTest_Fast(const wide_t &depth, const wide_t &stored, tiny3d::DepthFormat depth_format)
+{
+	return depth_format == tiny3d::DepthFormat_InvZ ? depth >= stored : depth <= stored;
+}
+
+struct TriangleSetup_Fast
+{
+	tiny3d::WideSInt w_x_inc[3], w_y_inc[3];
+	tiny3d::WideReal l_x_inc[3], l_y_inc[3];
+	tiny3d::WideReal w[3];     // the 1/z of the vertices
+	tiny3d::WideReal inv_w[3]; // the z of the vertices
+	tiny3d::WideSInt max_x, max_y;
+	tiny3d::DepthFormat depth_format;
+};
+
+// @algo SubdivisionSize
+// @in perspective -> The perspective mode.
+// @out The distance in pixels between exact perspective divides, or 0 if the divide is computed per pixel.
+constexpr tiny3d::SInt SubdivisionSize(tiny3d::PerspectiveMode perspective)
+{
+	return perspective == tiny3d::PerspectiveMode_Subdivide16 ? 16 : (perspective == tiny3d::PerspectiveMode_Subdivide8 ? 8 : 0);
+}
+
+// @algo ExactPerspective
+// @in perspective -> The perspective mode.
+// @out The perspective mode to use where a block of pixels has no corners to interpolate between. Subdivided modes divide exactly, others are kept.
+constexpr tiny3d::PerspectiveMode ExactPerspective(tiny3d::PerspectiveMode perspective)
+{
+	return SubdivisionSize(perspective) > 0 ? tiny3d::PerspectiveMode_Correct : perspective;
+}
+
+// @algo MaxSubdivisionRatio
+// @out The largest ratio between 1/z at the corners of a block that subdivided perspective modes interpolate linearly. Midway between two corners with the ratio k the linearly interpolated weights are off by (k - 1) / (2k + 2) of their change across the block, so this keeps the error near 3%.
+constexpr float MaxSubdivisionRatio( void )
+{
+	return 1.125f;
+}
+
+// @data BlockCorners_Fast
+// @info The 1/z and the exact perspective correct barycentric weights at the four corners of a block (top-left, top-right, bottom-left, bottom-right). Subdivided perspective modes interpolate these linearly inside of the block. 1/z is linear in screen space, so interpolating it is exact.
+struct BlockCorners_Fast
+{
+	float w[4];
+	float L[3][4];
+};
+
+// @algo PerspectiveCorners_Fast
+// @info Computes the exact perspective correct values at the corners of a block. The corners are shared with the neighboring blocks, so interpolation is continuous across blocks.
+// @inout corners -> Receives the values at the corners.
+// @out FALSE if 1/z varies across the block by more than MaxSubdivisionRatio, in which case the block must divide per fragment instead.
+// @note Corners may lie outside of the triangle. There the weights are extrapolated along the plane of the triangle, which stays exact as long as 1/z is positive. The ratio test rejects blocks where it is not, as well as blocks where linear interpolation of the weights would be far off.
+template < typename vert_t >
+bool PerspectiveCorners_Fast(const vert_t &a, const vert_t &b, const vert_t &c, float inv_area_x2, tiny3d::Point min, tiny3d::SInt size, BlockCorners_Fast &corners)
+{
+	float l[3][4];
+	for (int i = 0; i < 4; ++i) {
+		const tiny3d::Point p = { min.x + (i & 1) * size, min.y + (i >> 1) * size };
+		l[0][i]      = tiny3d::SInt(DetermineHalfspace(b.p, c.p, p)) * inv_area_x2;
+		l[1][i]      = tiny3d::SInt(DetermineHalfspace(c.p, a.p, p)) * inv_area_x2;
+		l[2][i]      = tiny3d::SInt(DetermineHalfspace(a.p, b.p, p)) * inv_area_x2;
+		corners.w[i] = a.w * l[0][i] + b.w * l[1][i] + c.w * l[2][i];
+	}
+	const float min_w = tiny3d::Min(tiny3d::Min(corners.w[0], corners.w[1]), tiny3d::Min(corners.w[2], corners.w[3]));
+	const float max_w = tiny3d::Max(tiny3d::Max(corners.w[0], corners.w[1]), tiny3d::Max(corners.w[2], corners.w[3]));
+	if (min_w <= 0.0f || max_w > min_w * MaxSubdivisionRatio()) { return false; }
+	for (int i = 0; i < 4; ++i) {
+		const float z = 1.0f / corners.w[i];
+		for (int j = 0; j < 3; ++j) {
+			corners.L[j][i] = l[j][i] * z;
+		}
+	}
+	return true;
+}
+
+// @data BlockLerp_Fast
+// @info Bilinearly interpolates a value given at the corners of a block over the SIMD fragments of the block, one row of fragments at a time.
+class BlockLerp_Fast
+{
+private:
+	tiny3d::WideReal m_left, m_right;         // the values at the left and right edge of the block for the current row
+	tiny3d::WideReal m_left_inc, m_right_inc; // the change per row of fragments
+	tiny3d::WideReal m_x_offset;              // the normalized x offset of the lanes within a fragment
+	float            m_x_inc;                 // the normalized distance between two fragments
+
+public:
+	BlockLerp_Fast( void ) {}
+	BlockLerp_Fast(const float *corners, tiny3d::SInt size)
+	{
+		static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+		static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+		const float            inv_size = 1.0f / size;
+		const tiny3d::WideReal ty       = tiny3d::WideReal(tiny3d::WideSInt(Y_COORD_OFFSET)) * inv_size;
+		m_left      = tiny3d::WideReal(corners[0]) + tiny3d::WideReal(corners[2] - corners[0]) * ty;
+		m_right     = tiny3d::WideReal(corners[1]) + tiny3d::WideReal(corners[3] - corners[1]) * ty;
+		m_left_inc  = (corners[2] - corners[0]) * (TINY_BLOCK_Y * inv_size);
+		m_right_inc = (corners[3] - corners[1]) * (TINY_BLOCK_Y * inv_size);
+		m_x_offset  = tiny3d::WideReal(tiny3d::WideSInt(X_COORD_OFFSET)) * inv_size;
+		m_x_inc     = TINY_BLOCK_X * inv_size;
+	}
+
+	// @algo Row
+	// @info Begins a row of fragments.
+	// @inout x_inc -> The change in value between two fragments on the row.
+	// @out The value at the first fragment of the row.
+	tiny3d::WideReal Row(tiny3d::WideReal &x_inc) const
+	{
+		const tiny3d::WideReal delta = m_right - m_left;
+		x_inc = delta * m_x_inc;
+		return m_left + delta * m_x_offset;
+	}
+
+	// @algo NextRow
+	// @info Advances to the next row of fragments.
+	void NextRow( void )
+	{
+		m_left  += m_left_inc;
+		m_right += m_right_inc;
+	}
+};
+
+// @algo ShadeFragment_Fast
+// @info Computes the depth of a SIMD fragment, tests it against the depth buffer, and passes the visible lanes to a shader together with the perspective correct barycentric weights.
+// @in
+//   zr, zw -> The depth value of the first lane of the fragment in the depth buffers to read from and write to.
+//   p -> The coordinate of the first lane of the fragment.
+//   fragment_mask -> The lanes covered by the triangle.
+//   l -> The screen space barycentric weights of the lanes. Unused by subdivided perspective modes.
+//   v -> The 1/z and perspective correct barycentric weights of the lanes interpolated from the corners of a block. Only used by subdivided perspective modes.
+//   z -> The z of the lanes if already known, e.g. for triangles of constant depth along a line of fragments. Only used to correct the weights for perspective, while depth is still computed per fragment. NULL to divide per fragment.
+template < tiny3d::PerspectiveMode perspective, typename depth_t, typename shader_t >
+void ShadeFragment_Fast(tiny3d::Image &dst, const depth_t *zr, depth_t *zw, tiny3d::UPoint p, tiny3d::WideBool fragment_mask, const tiny3d::WideReal *l, const tiny3d::WideReal *v, const tiny3d::WideReal *z, const TriangleSetup_Fast &setup, const shader_t &shader)
+{
+	static constexpr bool SUBDIVIDE = SubdivisionSize(perspective) > 0;
+	TINY3D_STATS_ADD(fragments_covered, tiny3d::CountBits(fragment_mask.to_bits()));
+
+	// NOTE: Attributes are stored divided by z, so multiplying the screen space weights by z of the vertices in affine mode interpolates the attributes themselves linearly.
+	const tiny3d::WideReal w     = SUBDIVIDE ? tiny3d::WideReal(0.0f) : setup.w[0] * l[0] + setup.w[1] * l[1] + setup.w[2] * l[2];
+	const bool             inv_z = setup.depth_format == tiny3d::DepthFormat_InvZ;
+	tiny3d::WideReal       depth;
+	if (SUBDIVIDE) {
+		// NOTE: 1/z is interpolated exactly between the corners of the block, but z is not linear in screen space and still needs the divide.
+		depth = (inv_z || shader_t::USES_DEPTH == false) ? v[0] : tiny3d::WideReal(1.0f) / v[0];
+	} else if (inv_z) {
+		depth = w;
+	} else if ((perspective == tiny3d::PerspectiveMode_Affine || z != nullptr) && shader_t::USES_DEPTH == false) {
+		depth = tiny3d::WideReal(0.0f); // the reciprocal is only needed for depth
+	} else {
+		depth = tiny3d::WideReal(1.0f) / w;
+	}
+
+	const typename DepthBuffer_Fast<depth_t>::wide_t stored_depth = DepthBuffer_Fast<depth_t>::Encode(depth, setup.depth_format);
+
+	if (shader_t::DEPTH_READ) {
+		const bool     inside     = p.x + TINY_BLOCK_X <= internal_impl::SurfaceAccess::GetWidth(dst) && p.y + TINY_BLOCK_Y <= internal_impl::SurfaceAccess::GetHeight(dst);
+		const tiny3d::WideBool depth_mask = DepthTest_Fast(stored_depth, LoadDepth_Fast(zr, internal_impl::SurfaceAccess::GetWidth(dst), inside, fragment_mask), setup.depth_format);
+		TINY3D_STATS_ADD(fragments_depth_rejected, tiny3d::CountBits(fragment_mask.to_bits() & ~depth_mask.to_bits()));
+		fragment_mask = fragment_mask & depth_mask;
+	}
+
+	if (fragment_mask.all_fail() == false) {
+		if (SUBDIVIDE) {
+			shader(p, zw, fragment_mask, stored_depth, v[1], v[2], v[3]);
+		} else if (perspective == tiny3d::PerspectiveMode_Affine) {
+			shader(p, zw, fragment_mask, stored_depth, l[0] * setup.inv_w[0], l[1] * setup.inv_w[1], l[2] * setup.inv_w[2]);
+		} else {
+			// NOTE: The z of the line saves a divide where depth does not already hold the exact z.
+			const tiny3d::WideReal sz = (z != nullptr && (inv_z || shader_t::USES_DEPTH == false)) ? *z : (inv_z ? tiny3d::WideReal(1.0f) / w : depth);
+			shader(p, zw, fragment_mask, stored_depth, l[0] * sz, l[1] * sz, l[2] * sz);
+		}
+	}
+}
+
+// @algo RasterizeBlock_Fast
+// @info Steps through the SIMD fragments of a block, tests depth, and passes the visible fragments to a shader together with the depth and perspective correct barycentric weights of the fragment. Coverage is only tested per fragment if the block is partially covered. With a 1/z depth buffer the depth test is done before the perspective divide, so occluded fragments never divide.
+template < bool test_coverage, tiny3d::PerspectiveMode perspective, typename depth_t, typename shader_t >
+void RasterizeBlock_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, tiny3d::Point min, tiny3d::Point max, tiny3d::WidePoint q, const tiny3d::WideSInt *w_y0, const tiny3d::WideReal *l_y0, const BlockCorners_Fast &corners, const TriangleSetup_Fast &setup, const shader_t &shader)
+{
+	static constexpr tiny3d::SInt SIMD_X_TILE = TINY_BLOCK_X;
+	static constexpr tiny3d::SInt SIMD_Y_TILE = TINY_BLOCK_Y;
+	static constexpr bool SUBDIVIDE   = SubdivisionSize(perspective) > 0;
+
+	tiny3d::WideSInt w0_y = w_y0[0], w1_y = w_y0[1], w2_y = w_y0[2];
+	tiny3d::WideReal l0_y = l_y0[0], l1_y = l_y0[1], l2_y = l_y0[2];
+	const tiny3d::WideSInt x0 = q.x;
+
+	BlockLerp_Fast lerp[4];
+	if (SUBDIVIDE) {
+		lerp[0] = BlockLerp_Fast(corners.w, SubdivisionSize(perspective));
+		for (int i = 0; i < 3; ++i) {
+			lerp[i + 1] = BlockLerp_Fast(corners.L[i], SubdivisionSize(perspective));
+		}
+	}
+
+	const tiny3d::UInt zoffset       = tiny3d::UInt(min.x) + dst.GetWidth() * tiny3d::UInt(min.y);
+	const depth_t     *zread_offset  = zread  != nullptr ? &((*zread)[zoffset])  : nullptr;
+	depth_t           *zwrite_offset = zwrite != nullptr ? &((*zwrite)[zoffset]) : nullptr;
+
+	for (tiny3d::SInt y = min.y; y <= max.y; y += SIMD_Y_TILE) {
+
+		tiny3d::WideSInt w0 = w0_y;
+		tiny3d::WideSInt w1 = w1_y;
+		tiny3d::WideSInt w2 = w2_y;
+
+		tiny3d::WideReal l0 = l0_y;
+		tiny3d::WideReal l1 = l1_y;
+		tiny3d::WideReal l2 = l2_y;
+
+		tiny3d::WideReal v[4], v_inc[4];
+		if (SUBDIVIDE) {
+			for (int i = 0; i < 4; ++i) {
+				v[i] = lerp[i].Row(v_inc[i]);
+			}
+		}
+
+		const depth_t *zr = zread_offset;
+		depth_t       *zw = zwrite_offset;
+
+		for (tiny3d::SInt x = min.x; x <= max.x; x += SIMD_X_TILE) {
+
+			// NOTE: Lanes past the right or bottom edge of the last SIMD fragments must not leak outside of the mask rectangle.
+			const tiny3d::WideBool bounds_mask   = (q.x <= setup.max_x) & (q.y <= setup.max_y);
+			tiny3d::WideBool       fragment_mask = test_coverage ? (((w0 | w1 | w2) >= 0) & bounds_mask) : bounds_mask;
+
+			if (fragment_mask.all_fail() == false) {
+				const tiny3d::WideReal l[3] = { l0, l1, l2 };
+				ShadeFragment_Fast<perspective>(dst, zr, zw, tiny3d::UPoint{ tiny3d::UInt(x), tiny3d::UInt(y) }, fragment_mask, l, v, nullptr, setup, shader);
+			}
+
+			if (test_coverage) {
+				w0 += setup.w_x_inc[0];
+				w1 += setup.w_x_inc[1];
+				w2 += setup.w_x_inc[2];
+			}
+
+			if (SUBDIVIDE) {
+				for (int i = 0; i < 4; ++i) {
+					v[i] += v_inc[i];
+				}
+			} else {
+				l0 += setup.l_x_inc[0];
+				l1 += setup.l_x_inc[1];
+				l2 += setup.l_x_inc[2];
+			}
+
+			q.x += SIMD_X_TILE;
+
+			if (zr) { zr += SIMD_X_TILE; }
+			if (zw) { zw += SIMD_X_TILE; }
+		}
+
+		if (test_coverage) {
+			w0_y += setup.w_y_inc[0];
+			w1_y += setup.w_y_inc[1];
+			w2_y += setup.w_y_inc[2];
+		}
+
+		if (SUBDIVIDE) {
+			for (int i = 0; i < 4; ++i) {
+				lerp[i].NextRow();
+			}
+		} else {
+			l0_y += setup.l_y_inc[0];
+			l1_y += setup.l_y_inc[1];
+			l2_y += setup.l_y_inc[2];
+		}
+
+		q.x = x0;
+		q.y += SIMD_Y_TILE;
+
+		if (zread_offset)  { zread_offset  += dst.GetWidth() * SIMD_Y_TILE; }
+		if (zwrite_offset) { zwrite_offset += dst.GetWidth() * SIMD_Y_TILE; }
+	}
+}
+
+// @algo HiZMargin
+// @out The relative margin added to upper bounds of w to cover the rounding errors of interpolating w per fragment.
+constexpr float HiZMargin( void )
+{
+	return 1.0f / 1024.0f;
+}
+
+// @algo IsHidden_HiZ
+// @info Tests the nearest depth of a rectangle against the farthest depth of all tiles of a coarse depth buffer overlapping the rectangle.
+// @in
+//   hiz -> The coarse depth buffer.
+//   min, max -> The inclusive bounds of the rectangle in pixels.
+//   max_w -> An upper bound of w over all fragments in the rectangle.
+//   depth_format -> The format of the depth buffer.
+// @out TRUE if no fragment in the rectangle can pass the depth test.
+template < typename depth_t >
+bool IsHidden_HiZ(const tiny3d::HiZBuffer &hiz, tiny3d::Point min, tiny3d::Point max, float max_w, tiny3d::DepthFormat depth_format)
+{
+	const float        nearest = float(EncodeDepth<depth_t>((depth_format == tiny3d::DepthFormat_InvZ) ? max_w : 1.0f / max_w, depth_format));
+	const tiny3d::UInt max_tx  = tiny3d::UInt(max.x) / tiny3d::HiZBuffer::TileSize();
+	const tiny3d::UInt max_ty  = tiny3d::UInt(max.y) / tiny3d::HiZBuffer::TileSize();
+	for (tiny3d::UInt ty = tiny3d::UInt(min.y) / tiny3d::HiZBuffer::TileSize(); ty <= max_ty; ++ty) {
+		for (tiny3d::UInt tx = tiny3d::UInt(min.x) / tiny3d::HiZBuffer::TileSize(); tx <= max_tx; ++tx) {
+			if (DepthTest(nearest, hiz.GetFarthest(tx, ty), depth_format)) { return false; }
+		}
+	}
+	return true;
+}
+
+// @algo MaxBlockW_Fast
+// @info Computes an upper bound of w over a block from the values of w at the corners of the block, since w is linear in screen space. Each corner is padded by the rounding error of interpolating w there.
+// @in
+//   a, b, c -> The vertices of the triangle.
+//   inv_area_x2 -> The inverse of the doubled area of the triangle.
+//   min -> The upper left corner of the block.
+//   size -> The width and height of the block.
+//   max_w -> An upper bound of w over the entire triangle.
+// @out The upper bound of w over the block.
+template < typename vert_t >
+float MaxBlockW_Fast(const vert_t &a, const vert_t &b, const vert_t &c, float inv_area_x2, tiny3d::Point min, tiny3d::SInt size, float max_w)
+{
+	float w = -max_w;
+	for (int i = 0; i < 4; ++i) {
+		const tiny3d::Point p = { min.x + (i & 1) * size, min.y + (i >> 1) * size };
+		const float w0 = a.w * (tiny3d::SInt(DetermineHalfspace(b.p, c.p, p)) * inv_area_x2);
+		const float w1 = b.w * (tiny3d::SInt(DetermineHalfspace(c.p, a.p, p)) * inv_area_x2);
+		const float w2 = c.w * (tiny3d::SInt(DetermineHalfspace(a.p, b.p, p)) * inv_area_x2);
+		w = tiny3d::Max(w, w0 + w1 + w2 + (tiny3d::Abs(w0) + tiny3d::Abs(w1) + tiny3d::Abs(w2)) * HiZMargin());
+	}
+	return tiny3d::Min(w, max_w);
+}
+
+// @algo SmallTriangleSize
+// @out The largest width and height in pixels of the bounding box of a triangle rasterized by RasterizeSmallTriangle_Fast. Must be a multiple of the SIMD tile dimensions.
+constexpr tiny3d::SInt SmallTriangleSize( void )
+{
+	return 8;
+}
+
+// @algo RasterizeSmallTriangle_Fast
+// @info Rasterizes a triangle whose bounding box fits inside of SmallTriangleSize. Such a triangle touches a few SIMD fragments in a pattern too irregular for branch prediction, so instead of the interpolation setup, block classification and coarse depth tests of larger triangles, coverage is tested for every fragment of the bounding box without branching, and only the covered fragments are visited. Subdivided perspective modes divide per fragment, which costs fewer divisions than the corners of a block.
+// @in
+//   a, b, c -> The vertices of the triangle.
+//   bias -> The fill convention offsets of the edges bc, ca and ab.
+//   inv_area_x2 -> The inverse of the doubled area of the triangle.
+//   min -> The top left corner of the clipped bounding box of the triangle.
+template < tiny3d::PerspectiveMode perspective, typename depth_t, typename vert_t, typename shader_t >
+void RasterizeSmallTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::SInt *bias, float inv_area_x2, tiny3d::Point min, const TriangleSetup_Fast &setup, const shader_t &shader)
+{
+	static constexpr tiny3d::SInt SIMD_X_TILE      = TINY_BLOCK_X;
+	static constexpr tiny3d::SInt SIMD_Y_TILE      = TINY_BLOCK_Y;
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	static constexpr tiny3d::SInt COLUMNS          = SmallTriangleSize() / SIMD_X_TILE;
+	static constexpr tiny3d::SInt ROWS             = SmallTriangleSize() / SIMD_Y_TILE;
+
+	const tiny3d::SInt      w_x_inc[3] = { (b.p.y - c.p.y) * SIMD_X_TILE, (c.p.y - a.p.y) * SIMD_X_TILE, (a.p.y - b.p.y) * SIMD_X_TILE };
+	const tiny3d::SInt      w_y_inc[3] = { (c.p.x - b.p.x) * SIMD_Y_TILE, (a.p.x - c.p.x) * SIMD_Y_TILE, (b.p.x - a.p.x) * SIMD_Y_TILE };
+	const tiny3d::WidePoint q0         = { tiny3d::WideSInt(min.x) + tiny3d::WideSInt(X_COORD_OFFSET), tiny3d::WideSInt(min.y) + tiny3d::WideSInt(Y_COORD_OFFSET) };
+	const tiny3d::WideSInt  w0[3]      = {
+		DetermineHalfspace_Fast(b.p, c.p, q0),
+		DetermineHalfspace_Fast(c.p, a.p, q0),
+		DetermineHalfspace_Fast(a.p, b.p, q0)
+	};
+
+	// NOTE: Lanes past the right or bottom edge of the bounding box must not leak outside of the mask rectangle.
+	tiny3d::WideBool column_mask[COLUMNS], row_mask[ROWS];
+	for (tiny3d::SInt column = 0; column < COLUMNS; ++column) { column_mask[column] = q0.x + tiny3d::WideSInt(column * SIMD_X_TILE) <= setup.max_x; }
+	for (tiny3d::SInt row = 0; row < ROWS; ++row)             { row_mask[row]       = q0.y + tiny3d::WideSInt(row * SIMD_Y_TILE) <= setup.max_y; }
+
+	// Coverage
+	int              covered[COLUMNS * ROWS]; // the indices of the covered fragments
+	tiny3d::SInt     count   = 0;
+	tiny3d::WideSInt w_y[3]  = { w0[0] + tiny3d::WideSInt(bias[0]), w0[1] + tiny3d::WideSInt(bias[1]), w0[2] + tiny3d::WideSInt(bias[2]) };
+	for (tiny3d::SInt row = 0; row < ROWS; ++row) {
+		tiny3d::WideSInt w[3] = { w_y[0], w_y[1], w_y[2] };
+		for (tiny3d::SInt column = 0; column < COLUMNS; ++column) {
+			covered[count] = column + row * COLUMNS;
+			count += ((((w[0] | w[1] | w[2]) >= 0) & column_mask[column] & row_mask[row]).to_bits() != 0) ? 1 : 0;
+			for (int j = 0; j < 3; ++j) {
+				w[j] += tiny3d::WideSInt(w_x_inc[j]);
+			}
+		}
+		for (int j = 0; j < 3; ++j) {
+			w_y[j] += tiny3d::WideSInt(w_y_inc[j]);
+		}
+	}
+
+	// Shading
+	for (tiny3d::SInt i = 0; i < count; ++i) {
+		const tiny3d::SInt     column        = covered[i] % COLUMNS;
+		const tiny3d::SInt     row           = covered[i] / COLUMNS;
+		const tiny3d::SInt     x             = min.x + column * SIMD_X_TILE;
+		const tiny3d::SInt     y             = min.y + row * SIMD_Y_TILE;
+		const tiny3d::WideSInt w[3]          = {
+			w0[0] + tiny3d::WideSInt(column * w_x_inc[0] + row * w_y_inc[0]),
+			w0[1] + tiny3d::WideSInt(column * w_x_inc[1] + row * w_y_inc[1]),
+			w0[2] + tiny3d::WideSInt(column * w_x_inc[2] + row * w_y_inc[2])
+		};
+		const tiny3d::WideBool fragment_mask = (((w[0] + tiny3d::WideSInt(bias[0])) | (w[1] + tiny3d::WideSInt(bias[1])) | (w[2] + tiny3d::WideSInt(bias[2]))) >= 0) & column_mask[column] & row_mask[row];
+		const tiny3d::UInt     zoffset       = tiny3d::UInt(x) + internal_impl::SurfaceAccess::GetWidth(dst) * tiny3d::UInt(y);
+		const tiny3d::WideReal l[3]          = { tiny3d::WideReal(w[0]) * inv_area_x2, tiny3d::WideReal(w[1]) * inv_area_x2, tiny3d::WideReal(w[2]) * inv_area_x2 };
+		ShadeFragment_Fast<ExactPerspective(perspective)>(dst, zread != nullptr ? &((*zread)[zoffset]) : nullptr, zwrite != nullptr ? &((*zwrite)[zoffset]) : nullptr, tiny3d::UPoint{ tiny3d::UInt(x), tiny3d::UInt(y) }, fragment_mask, l, nullptr, nullptr, setup, shader);
+	}
+}
+
+// @algo RasterizeBlocks_Fast
+// @info Traverses the bounding box of a triangle in blocks of pixels. Blocks outside of the triangle are skipped, blocks inside of the triangle are shaded without any coverage tests, and only partially covered blocks test coverage per fragment. Large triangles spend most of their bounding box outside of the triangle, so this avoids evaluating edge functions for most of the empty space.
+// @in
+//   a, b, c -> The vertices of the triangle.
+//   bias -> The fill convention offsets of the edges bc, ca and ab.
+//   inv_area_x2 -> The inverse of the doubled area of the triangle.
+//   min, max -> The inclusive clipped bounding box of the triangle.
+//   hiz -> The coarse depth buffer to test blocks against. NULL to test no blocks.
+//   max_w -> An upper bound of w over the entire triangle.
+template < tiny3d::PerspectiveMode perspective, typename depth_t, typename vert_t, typename shader_t >
+void RasterizeBlocks_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::SInt *bias, float inv_area_x2, tiny3d::Point min, tiny3d::Point max, const tiny3d::HiZBuffer *hiz, float max_w, const TriangleSetup_Fast &setup, const shader_t &shader)
+{
+	static constexpr tiny3d::SInt BLOCK_SIZE       = SubdivisionSize(perspective) > 0 ? SubdivisionSize(perspective) : (TINY_WIDTH > 8 ? TINY_WIDTH : 8); // must be a multiple of the SIMD tile dimensions
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+
+	for (tiny3d::SInt by = min.y; by <= max.y; by += BLOCK_SIZE) {
+
+		const tiny3d::SInt block_max_y = tiny3d::Min(by + BLOCK_SIZE - 1, max.y);
+
+		for (tiny3d::SInt bx = min.x; bx <= max.x; bx += BLOCK_SIZE) {
+
+			const tiny3d::Point block_min = { bx, by };
+			const tiny3d::Point block_max = { tiny3d::Min(bx + BLOCK_SIZE - 1, max.x), block_max_y };
+			const BlockCoverage coverage  = ClassifyBlock(a.p, b.p, c.p, bias, block_min, block_max);
+
+			if (coverage == Block_Outside) { continue; }
+			if (hiz != nullptr && IsHidden_HiZ<depth_t>(*hiz, block_min, block_max, MaxBlockW_Fast(a, b, c, inv_area_x2, block_min, BLOCK_SIZE, max_w), setup.depth_format)) { continue; }
+
+			const tiny3d::WidePoint p      = { tiny3d::WideSInt(bx) + tiny3d::WideSInt(X_COORD_OFFSET), tiny3d::WideSInt(by) + tiny3d::WideSInt(Y_COORD_OFFSET) };
+			tiny3d::WideSInt        w_y[3] = {
+				DetermineHalfspace_Fast(b.p, c.p, p),
+				DetermineHalfspace_Fast(c.p, a.p, p),
+				DetermineHalfspace_Fast(a.p, b.p, p)
+			};
+			tiny3d::WideReal        l_y[3];
+			for (int i = 0; i < 3; ++i) {
+				l_y[i]  = tiny3d::WideReal(w_y[i]) * inv_area_x2;
+				w_y[i] += tiny3d::WideSInt(bias[i]);
+			}
+
+			BlockCorners_Fast corners;
+			if (SubdivisionSize(perspective) > 0 && PerspectiveCorners_Fast(a, b, c, inv_area_x2, block_min, BLOCK_SIZE, corners) == false) {
+				if (coverage == Block_Inside) {
+					RasterizeBlock_Fast<false, ExactPerspective(perspective)>(dst, zread, zwrite, block_min, block_max, p, w_y, l_y, corners, setup, shader);
+				} else {
+					RasterizeBlock_Fast<true, ExactPerspective(perspective)>(dst, zread, zwrite, block_min, block_max, p, w_y, l_y, corners, setup, shader);
+				}
+				continue;
+			}
+
+			if (coverage == Block_Inside) {
+				RasterizeBlock_Fast<false, perspective>(dst, zread, zwrite, block_min, block_max, p, w_y, l_y, corners, setup, shader);
+			} else {
+				RasterizeBlock_Fast<true, perspective>(dst, zread, zwrite, block_min, block_max, p, w_y, l_y, corners, setup, shader);
+			}
+		}
+	}
+}
+
+// @algo RasterizeSpans_Fast
+// @info Traverses a triangle one line of SIMD fragments at a time, rows or columns. The covered pixels of every scanline in the line are found with ClipScanline, and only the SIMD fragments overlapping them are tested and shaded. Long diagonal slivers cover few of the pixels in their bounding box and in most of the blocks they touch, so this avoids testing the empty space the block traversal can not skip. Triangles of constant depth along the lines, like floors along rows and walls along columns, correct their attributes for perspective with one divide per line instead of one per fragment. Depth is still computed per fragment.
+// @in
+//   a, b, c -> The vertices of the triangle.
+//   bias -> The fill convention offsets of the edges bc, ca and ab.
+//   inv_area_x2 -> The inverse of the doubled area of the triangle.
+//   min, max -> The inclusive clipped bounding box of the triangle.
+//   hiz -> The coarse depth buffer to test lines against. NULL to test no lines.
+//   max_w -> An upper bound of w over the entire triangle.
+//   vertical -> TRUE to traverse columns, FALSE to traverse rows.
+//   constant_z -> TRUE if depth is constant along the lines.
+// @note Only for perspective modes that are not subdivided, since subdivision interpolates between the corners of blocks.
+template < tiny3d::PerspectiveMode perspective, typename depth_t, typename vert_t, typename shader_t >
+void RasterizeSpans_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::SInt *bias, float inv_area_x2, tiny3d::Point min, tiny3d::Point max, const tiny3d::HiZBuffer *hiz, float max_w, bool vertical, bool constant_z, const TriangleSetup_Fast &setup, const shader_t &shader)
+{
+	static constexpr tiny3d::SInt SIMD_X_TILE      = TINY_BLOCK_X;
+	static constexpr tiny3d::SInt SIMD_Y_TILE      = TINY_BLOCK_Y;
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	TINY3D_ASSERT(SubdivisionSize(perspective) == 0);
+
+	const tiny3d::SInt line_size = vertical ? SIMD_X_TILE : SIMD_Y_TILE; // the number of scanlines in a line of fragments
+	const tiny3d::SInt step      = vertical ? SIMD_Y_TILE : SIMD_X_TILE; // the distance between fragments along a line
+
+	const tiny3d::SInt w_x_inc[3] = { b.p.y - c.p.y, c.p.y - a.p.y, a.p.y - b.p.y };
+	const tiny3d::SInt w_y_inc[3] = { c.p.x - b.p.x, a.p.x - c.p.x, b.p.x - a.p.x };
+	const tiny3d::SInt *span_inc  = vertical ? w_y_inc : w_x_inc;
+	const tiny3d::SInt *line_inc  = vertical ? w_x_inc : w_y_inc;
+	const tiny3d::SInt span_min   = vertical ? min.y : min.x;
+	const tiny3d::SInt span_max   = vertical ? max.y : max.x;
+	const tiny3d::SInt line_max   = vertical ? max.x : max.y;
+	tiny3d::SXInt      w_line[3]  = {
+		DetermineHalfspace(b.p, c.p, min) + bias[0],
+		DetermineHalfspace(c.p, a.p, min) + bias[1],
+		DetermineHalfspace(a.p, b.p, min) + bias[2]
+	};
+
+	const tiny3d::WideSInt *w_step = vertical ? setup.w_y_inc : setup.w_x_inc;
+	const tiny3d::WideReal *l_step = vertical ? setup.l_y_inc : setup.l_x_inc;
+	const tiny3d::UInt      z_step = vertical ? dst.GetWidth() * SIMD_Y_TILE : SIMD_X_TILE;
+
+	for (tiny3d::SInt line = vertical ? min.x : min.y; line <= line_max; line += line_size) {
+
+		// The union of the covered spans of the scanlines in the line
+		tiny3d::SInt s0 = span_max + 1;
+		tiny3d::SInt s1 = span_min - 1;
+		for (tiny3d::SInt i = 0; i < line_size; ++i) {
+			if (line + i <= line_max) {
+				const tiny3d::SpanBuffer::Span covered = ClipScanline(w_line, span_inc, span_min, span_max);
+				if (covered.a < covered.b) {
+					s0 = tiny3d::Min(s0, tiny3d::SInt(covered.a));
+					s1 = tiny3d::Max(s1, tiny3d::SInt(covered.b) - 1);
+				}
+			}
+			for (int e = 0; e < 3; ++e) {
+				w_line[e] += line_inc[e];
+			}
+		}
+
+		if (s0 > s1) { continue; }
+		const tiny3d::SInt  line_end = tiny3d::Min(line + line_size - 1, line_max);
+		const tiny3d::Point first    = vertical ? tiny3d::Point{ line, s0 } : tiny3d::Point{ s0, line };
+		const tiny3d::Point last     = vertical ? tiny3d::Point{ line_end, s1 } : tiny3d::Point{ s1, line_end };
+		if (hiz != nullptr && IsHidden_HiZ<depth_t>(*hiz, first, last, max_w, setup.depth_format)) { continue; }
+
+		tiny3d::WidePoint q    = { tiny3d::WideSInt(first.x) + tiny3d::WideSInt(X_COORD_OFFSET), tiny3d::WideSInt(first.y) + tiny3d::WideSInt(Y_COORD_OFFSET) };
+		tiny3d::WideSInt  w[3] = {
+			DetermineHalfspace_Fast(b.p, c.p, q),
+			DetermineHalfspace_Fast(c.p, a.p, q),
+			DetermineHalfspace_Fast(a.p, b.p, q)
+		};
+		tiny3d::WideReal  l[3];
+		for (int e = 0; e < 3; ++e) {
+			l[e]  = tiny3d::WideReal(w[e]) * inv_area_x2;
+			w[e] += tiny3d::WideSInt(bias[e]);
+		}
+
+		// NOTE: Only lanes on different scanlines of the line differ in depth.
+		const tiny3d::WideReal z = constant_z ? tiny3d::WideReal(1.0f) / (setup.w[0] * l[0] + setup.w[1] * l[1] + setup.w[2] * l[2]) : tiny3d::WideReal(0.0f);
+
+		const tiny3d::UInt zoffset = tiny3d::UInt(first.x) + dst.GetWidth() * tiny3d::UInt(first.y);
+		const depth_t *zr  = zread  != nullptr ? &((*zread)[zoffset])  : nullptr;
+		depth_t       *zw  = zwrite != nullptr ? &((*zwrite)[zoffset]) : nullptr;
+
+		for (tiny3d::SInt s = s0; s <= s1; s += step) {
+
+			// NOTE: Lanes past the right or bottom edge of the bounding box must not leak outside of the mask rectangle.
+			const tiny3d::WideBool fragment_mask = (((w[0] | w[1] | w[2]) >= 0) & (q.x <= setup.max_x) & (q.y <= setup.max_y));
+			if (fragment_mask.all_fail() == false) {
+				const tiny3d::UPoint p = vertical ? tiny3d::UPoint{ tiny3d::UInt(line), tiny3d::UInt(s) } : tiny3d::UPoint{ tiny3d::UInt(s), tiny3d::UInt(line) };
+				ShadeFragment_Fast<perspective>(dst, zr, zw, p, fragment_mask, l, nullptr, constant_z ? &z : nullptr, setup, shader);
+			}
+
+			for (int e = 0; e < 3; ++e) {
+				w[e] += w_step[e];
+				l[e] += l_step[e];
+			}
+			if (vertical) { q.y += step; } else { q.x += step; }
+
+			if (zr) { zr += z_step; }
+			if (zw) { zw += z_step; }
+		}
+	}
+}
+
+// @algo ConstantDepthTolerance
+// @in perspective -> The perspective mode.
+// @out The largest relative change of depth along a line of pixels for which the depth of a triangle is considered constant along that line when correcting its attributes for perspective. Exact modes only accept changes within float rounding. Subdivided modes accept far more, since the error is still far below that of interpolating between the corners of their blocks.
+constexpr float ConstantDepthTolerance(tiny3d::PerspectiveMode perspective)
+{
+	return SubdivisionSize(perspective) > 0 ? 1.0f / 1024.0f : 1.0f / 4194304.0f;
+}
+
+// @algo IsConstantDepth
+// @info Tests if the depth of a triangle is constant along one axis, as for floors along rows and walls along columns of axis-aligned architecture.
+// @in
+//   w_inc -> The change of 1/z per pixel along the axis.
+//   length -> The length of the bounding box of the triangle along the axis.
+//   min_w -> The 1/z of the farthest vertex.
+//   tolerance -> The largest relative change of depth along the axis. See ConstantDepthTolerance.
+// @out TRUE if depth changes by no more than the tolerance along the axis.
+bool IsConstantDepth(float w_inc, tiny3d::SInt length, float min_w, float tolerance)
+{
+	return tiny3d::Abs(w_inc) * length <= min_w * tolerance;
+}
+
+// @algo UpdateHiZ_Fast
+// @info Tightens the tiles of a coarse depth buffer touched by a triangle after it was drawn with depth read and write. If every visible fragment of the triangle wrote depth, every pixel of a tile entirely covered by the triangle is either at the depth of the triangle or nearer, so the farthest depth of the triangle over the tile bounds the tile without reading the depth buffer. The remaining touched tiles, along the edges of the triangle or all of them if e.g. the stencil or transparent texels left pixels unwritten, are rescanned from the depth buffer in runs along each row. Rescanning costs a read of each pixel of the tiles, so heavy overdraw drawn back to front only pays for it along the edges of triangles.
+// @in
+//   hiz -> The coarse depth buffer.
+//   depth -> The depth buffer that was written to.
+//   a, b, c -> The vertices of the triangle.
+//   bias -> The fill convention offsets of the edges bc, ca and ab.
+//   inv_area_x2 -> The inverse of the doubled area of the triangle.
+//   min, max -> The inclusive clipped bounding box of the triangle.
+//   dst_rect -> The mask rectangle. NULL for the entire buffer.
+//   depth_format -> The format of the depth buffer.
+//   depth_complete -> TRUE if every fragment that passed the depth test wrote depth.
+template < typename depth_t, typename vert_t >
+void UpdateHiZ_Fast(tiny3d::HiZBuffer &hiz, const tiny3d::Array<depth_t> &depth, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::SInt *bias, float inv_area_x2, tiny3d::Point min, tiny3d::Point max, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, bool depth_complete)
+{
+	static constexpr tiny3d::SInt TILE_SIZE = tiny3d::SInt(tiny3d::HiZBuffer::TileSize());
+	const tiny3d::SInt  width  = tiny3d::SInt(hiz.GetWidth());
+	const tiny3d::SInt  height = tiny3d::SInt(hiz.GetHeight());
+	const tiny3d::Point origin = { min.x / TILE_SIZE * TILE_SIZE, min.y / TILE_SIZE * TILE_SIZE };
+	const float         min_w  = tiny3d::Min(a.w, b.w, c.w) * (1.0f - HiZMargin());
+	if (min_w <= 0.0f) { depth_complete = false; }
+
+	// NOTE: The edge functions and w are linear in screen space, so they are evaluated at the first tile and stepped from there. The bound of w is padded by the rounding error of the terms it is summed from.
+	const tiny3d::Point edges[3][2] = { { b.p, c.p }, { c.p, a.p }, { a.p, b.p } };
+	const float         vert_w[3]   = { a.w, b.w, c.w };
+	tiny3d::SXInt e_row[3], e_x[3], e_y[3];
+	float w0 = 0.0f, w0_err = 0.0f, w_x = 0.0f, w_x_err = 0.0f, w_y = 0.0f, w_y_err = 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		e_x[i]   = tiny3d::SXInt(edges[i][0].y - edges[i][1].y);
+		e_y[i]   = tiny3d::SXInt(edges[i][1].x - edges[i][0].x);
+		e_row[i] = DetermineHalfspace(edges[i][0], edges[i][1], origin);
+		const float l = vert_w[i] * (tiny3d::SInt(e_row[i]) * inv_area_x2);
+		const float x = vert_w[i] * (tiny3d::SInt(e_x[i]) * inv_area_x2);
+		const float y = vert_w[i] * (tiny3d::SInt(e_y[i]) * inv_area_x2);
+		w0  += l; w0_err  += tiny3d::Abs(l);
+		w_x += x; w_x_err += tiny3d::Abs(x);
+		w_y += y; w_y_err += tiny3d::Abs(y);
+		e_row[i] += bias[i];
+	}
+
+	for (tiny3d::SInt ty = origin.y; ty <= max.y; ty += TILE_SIZE) {
+		const tiny3d::SInt size_y = tiny3d::Min(ty + TILE_SIZE, height) - 1 - ty;
+		tiny3d::SXInt      e[3]   = { e_row[0], e_row[1], e_row[2] };
+		tiny3d::SInt       run_x  = -1;
+		for (tiny3d::SInt tx = origin.x; tx <= max.x + TILE_SIZE; tx += TILE_SIZE) { // one past the last tile to end the last run
+			const tiny3d::SInt size_x  = tiny3d::Min(tx + TILE_SIZE, width) - 1 - tx;
+			bool               touched = tx <= max.x;
+			bool               covered = touched;
+			for (int i = 0; i < 3; ++i) {
+				touched = touched && e[i] + tiny3d::Max(tiny3d::SXInt(0), e_x[i] * size_x) + tiny3d::Max(tiny3d::SXInt(0), e_y[i] * size_y) >= 0;
+				covered = covered && e[i] + tiny3d::Min(tiny3d::SXInt(0), e_x[i] * size_x) + tiny3d::Min(tiny3d::SXInt(0), e_y[i] * size_y) >= 0;
+				e[i] += e_x[i] * TILE_SIZE;
+			}
+			// NOTE: A covered tile reaching outside of the clipped bounding box was only drawn in part.
+			if (depth_complete && covered && tx >= min.x && ty >= min.y && tx + size_x <= max.x && ty + size_y <= max.y) {
+				const float dx = float(tx - origin.x);
+				const float dy = float(ty - origin.y);
+				const float w  = tiny3d::Max(min_w,
+					w0 + w_x * dx + w_y * dy + tiny3d::Min(0.0f, w_x * size_x) + tiny3d::Min(0.0f, w_y * size_y) -
+					(w0_err + w_x_err * (dx + size_x) + w_y_err * (dy + size_y)) * HiZMargin()
+				);
+				hiz.Tighten(tiny3d::UInt(tx / TILE_SIZE), tiny3d::UInt(ty / TILE_SIZE), float(EncodeDepth<depth_t>((depth_format == tiny3d::DepthFormat_InvZ) ? w : 1.0f / w, depth_format)), depth_format);
+				touched = false;
+			}
+			if (touched && run_x < 0) {
+				run_x = tx;
+			} else if (!touched && run_x >= 0) {
+				tiny3d::URect rect = tiny3d::URect{ { tiny3d::UInt(run_x), tiny3d::UInt(ty) }, { tiny3d::UInt(tiny3d::Min(tx, width)), tiny3d::UInt(tiny3d::Min(ty + TILE_SIZE, height)) } };
+				if (dst_rect != nullptr) { rect = tiny3d::Clip(rect, *dst_rect); }
+				hiz.Update(depth, rect, depth_format);
+				run_x = -1;
+			}
+		}
+		for (int i = 0; i < 3; ++i) { e_row[i] += e_y[i] * TILE_SIZE; }
+	}
+}
+
+// @algo RasterizeTriangle_Fast
+// @info Sets up a triangle and selects how to traverse it. Small triangles are shaded fragment by fragment, triangles of constant depth along rows or columns and long diagonal slivers one line at a time, and everything else in blocks of pixels.
+template < tiny3d::PerspectiveMode perspective, typename depth_t, typename vert_t, typename shader_t >
+void RasterizeTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const vert_t &a, const vert_t &b, const vert_t &c, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, const shader_t &shader)
+{
+	static constexpr tiny3d::SInt SIMD_X_TILE = TINY_BLOCK_X;
+	static constexpr tiny3d::SInt SIMD_Y_TILE = TINY_BLOCK_Y;
+
+	// AABB Clipping
+	tiny3d::SInt min_y = tiny3d::Max(tiny3d::Min(a.p.y, b.p.y, c.p.y), tiny3d::SInt(0));
+	tiny3d::SInt max_y = tiny3d::Min(tiny3d::Max(a.p.y, b.p.y, c.p.y), tiny3d::SInt(dst.GetHeight() - 1));
+	if (max_y - min_y <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	tiny3d::SInt min_x = tiny3d::Max(tiny3d::Min(a.p.x, b.p.x, c.p.x), tiny3d::SInt(0)) & TINY_BLOCK_X_INVMASK; // aligned to the fragment width
+	tiny3d::SInt max_x = tiny3d::Min(tiny3d::Max(a.p.x, b.p.x, c.p.x), tiny3d::SInt(dst.GetWidth() - 1));
+	if (max_x - min_x <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+
+	if (dst_rect != nullptr) {
+		min_y = tiny3d::SInt(tiny3d::Max(tiny3d::UInt(min_y), dst_rect->a.y));
+		max_y = tiny3d::SInt(tiny3d::Min(tiny3d::UInt(max_y), dst_rect->b.y - 1));
+		min_x = tiny3d::SInt(tiny3d::Max(tiny3d::UInt(min_x), dst_rect->a.x));
+		max_x = tiny3d::SInt(tiny3d::Min(tiny3d::UInt(max_x), dst_rect->b.x - 1));
+	}
+
+	// Triangle setup
+	const tiny3d::SXInt area_x2 = DetermineHalfspace(b.p, c.p, a.p);
+	if (area_x2 <= 0) { TINY3D_STATS_ADD(triangles_culled, 1); return; } // no fragment passes the coverage test of a back facing or degenerate triangle
+	const float        inv_area_x2 = 1.0f / tiny3d::SInt(area_x2);
+	const tiny3d::SInt bias[3]     = { // add offsets to coordinates to enforce fill convention
+		IsTopLeft(b.p, c.p) ? 0 : -1,
+		IsTopLeft(c.p, a.p) ? 0 : -1,
+		IsTopLeft(a.p, b.p) ? 0 : -1
+	};
+
+	TriangleSetup_Fast setup;
+	setup.w[0] = a.w;
+	setup.w[1] = b.w;
+	setup.w[2] = c.w;
+	if (perspective == tiny3d::PerspectiveMode_Affine) { // only affine mode shades with the z of the vertices
+		setup.inv_w[0] = 1.0f / a.w;
+		setup.inv_w[1] = 1.0f / b.w;
+		setup.inv_w[2] = 1.0f / c.w;
+	}
+	setup.max_x = max_x;
+	setup.max_y = max_y;
+	setup.depth_format = depth_format;
+
+	// Small triangles are rasterized without interpolation setup or coarse depth tests, which cost more than the few fragments they touch
+	if (max_x - min_x < SmallTriangleSize() && max_y - min_y < SmallTriangleSize()) {
+		TINY3D_STATS_ADD(triangles_rasterized, 1);
+		TINY3D_STATS_ADD(bbox_pixels, BoundingBoxArea(tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }));
+		TINY3D_STATS_TIME(tiny3d::RenderStage_Raster);
+		RasterizeSmallTriangle_Fast<perspective>(dst, zread, zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, setup, shader);
+		return;
+	}
+
+	// Coarse depth rejection
+	const float max_w = tiny3d::Max(a.w, b.w, c.w) * (1.0f + HiZMargin());
+	if (zread == nullptr || max_w <= 0.0f) { hiz = nullptr; }
+	if (hiz != nullptr) {
+		TINY3D_ASSERT(hiz->GetWidth() == dst.GetWidth() && hiz->GetHeight() == dst.GetHeight());
+		if (IsHidden_HiZ<depth_t>(*hiz, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, max_w, depth_format)) { TINY3D_STATS_ADD(triangles_culled, 1); return; }
+	}
+
+	TINY3D_STATS_ADD(triangles_rasterized, 1);
+	TINY3D_STATS_ADD(bbox_pixels, BoundingBoxArea(tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }));
+	TINY3D_STATS_TIME(tiny3d::RenderStage_Raster);
+
+	// Interpolation setup
+	setup.w_x_inc[0] = (b.p.y - c.p.y) * SIMD_X_TILE;
+	setup.w_x_inc[1] = (c.p.y - a.p.y) * SIMD_X_TILE;
+	setup.w_x_inc[2] = (a.p.y - b.p.y) * SIMD_X_TILE;
+	setup.w_y_inc[0] = (c.p.x - b.p.x) * SIMD_Y_TILE;
+	setup.w_y_inc[1] = (a.p.x - c.p.x) * SIMD_Y_TILE;
+	setup.w_y_inc[2] = (b.p.x - a.p.x) * SIMD_Y_TILE;
+	for (int i = 0; i < 3; ++i) {
+		setup.l_x_inc[i] = tiny3d::WideReal(setup.w_x_inc[i]) * inv_area_x2;
+		setup.l_y_inc[i] = tiny3d::WideReal(setup.w_y_inc[i]) * inv_area_x2;
+	}
+
+	// Depth is constant along an axis if 1/z is, since 1/z is linear in screen space
+	const float min_w   = tiny3d::Min(a.w, b.w, c.w);
+	const float w_x_inc = (a.w * (b.p.y - c.p.y) + b.w * (c.p.y - a.p.y) + c.w * (a.p.y - b.p.y)) * inv_area_x2;
+	const float w_y_inc = (a.w * (c.p.x - b.p.x) + b.w * (a.p.x - c.p.x) + c.w * (b.p.x - a.p.x)) * inv_area_x2;
+
+	if (IsConstantDepth(w_x_inc, max_x - min_x + 1, min_w, ConstantDepthTolerance(perspective))) {
+		RasterizeSpans_Fast<ExactPerspective(perspective)>(dst, zread, zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, hiz, max_w, false, true, setup, shader);
+	} else if (IsConstantDepth(w_y_inc, max_y - min_y + 1, min_w, ConstantDepthTolerance(perspective))) {
+		RasterizeSpans_Fast<ExactPerspective(perspective)>(dst, zread, zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, hiz, max_w, true, true, setup, shader);
+	} else if (SubdivisionSize(perspective) == 0 && PreferScanlines(area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y })) {
+		RasterizeSpans_Fast<ExactPerspective(perspective)>(dst, zread, zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, hiz, max_w, false, false, setup, shader);
+	} else {
+		RasterizeBlocks_Fast<perspective>(dst, zread, zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, hiz, max_w, setup, shader);
+	}
+
+	// Depth writes with depth read only move tiles nearer, so tiles are only refreshed to tighten their bounds
+	if (hiz != nullptr && zwrite == zread) {
+		UpdateHiZ_Fast<depth_t>(*hiz, *zwrite, a, b, c, bias, inv_area_x2, tiny3d::Point{ min_x, min_y }, tiny3d::Point{ max_x, max_y }, dst_rect, depth_format, shader.depth_complete);
+	}
+}
+
+// @algo StoreDepth_Fast
+// @info Stores the depth values covered by a SIMD fragment. Only lanes inside of the fragment mask are written.
+// @in
+//   z -> The depth value of the first lane of the fragment.
+//   width -> The width of the depth buffer.
+//   depth -> The depth values.
+//   fragment_mask -> The lanes to store.
+void StoreDepth_Fast(float *z, tiny3d::UInt width, const tiny3d::WideReal &depth, const tiny3d::WideBool &fragment_mask)
+{
+	float values[TINY_WIDTH];
+	const unsigned int lanes = fragment_mask.to_bits();
+	depth.to_scalar(values);
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+		if (tiny3d::TestBit(lanes, i)) { z[FragmentOffset(i, width)] = values[i]; }
+	}
+}
+
+// @algo StoreDepth_Fast
+// @info Stores the values of a 16-bit depth buffer covered by a SIMD fragment.
+void StoreDepth_Fast(tiny3d::UHInt *z, tiny3d::UInt width, const tiny3d::WideSInt &depth, const tiny3d::WideBool &fragment_mask)
+{
+	int values[TINY_WIDTH];
+	const unsigned int lanes = fragment_mask.to_bits();
+	depth.to_scalar(values);
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+		if (tiny3d::TestBit(lanes, i)) { z[FragmentOffset(i, width)] = tiny3d::UHInt(values[i]); }
+	}
+}
+
+// @algo ClampByte_Fast
+// @info Clamps the lanes to the range of a Byte.
+tiny3d::WideSInt ClampByte_Fast(const tiny3d::WideSInt &x)
+{
+	return tiny3d::WideSInt::max(tiny3d::WideSInt::min(x, tiny3d::WideSInt(255)), tiny3d::WideSInt(0));
+}
+
+// @algo ClampBytes_Fast
+// @info Clamps the color channels to the range of a Byte. Interpolated colors may leave the range of the vertex colors through rounding or where the weights are slightly outside of the triangle, and must saturate rather than wrap around.
+tiny3d::WideColor ClampBytes_Fast(const tiny3d::WideColor &c)
+{
+	return tiny3d::WideColor{ ClampByte_Fast(c.r), ClampByte_Fast(c.g), ClampByte_Fast(c.b), c.blend };
+}
+
+// @algo Modulate_Fast
+// @info Multiplies colors the same way as tiny3d::Color's multiplication operator. The blend mode is kept from the left hand side.
+tiny3d::WideColor Modulate_Fast(const tiny3d::WideColor &l, const tiny3d::WideColor &r)
+{
+	return tiny3d::WideColor{
+		((l.r + tiny3d::WideSInt(1)) * (r.r + tiny3d::WideSInt(1)) - tiny3d::WideSInt(1)) >> 8,
+		((l.g + tiny3d::WideSInt(1)) * (r.g + tiny3d::WideSInt(1)) - tiny3d::WideSInt(1)) >> 8,
+		((l.b + tiny3d::WideSInt(1)) * (r.b + tiny3d::WideSInt(1)) - tiny3d::WideSInt(1)) >> 8,
+		l.blend
+	};
+}
+
+// @algo Dither2x2_Fast
+// @info Dithers the colors of a SIMD fragment the same way as tiny3d::Dither2x2.
+// @in
+//   c -> The colors.
+//   p -> The coordinate of the first lane of the fragment.
+// @out The dithered colors.
+tiny3d::WideColor Dither2x2_Fast(const tiny3d::WideColor &c, tiny3d::UPoint p)
+{
+	// NOTE: The dither pattern repeats every other pixel, so there are only four possible sets of offsets for a fragment.
+	struct Kernel
+	{
+		int offset[4][TINY_WIDTH];
+		Kernel( void )
+		{
+			for (tiny3d::UInt k = 0; k < 4; ++k) {
+				for (int i = 0; i < TINY_WIDTH; ++i) {
+					offset[k][i] = tiny3d::Dither2x2(tiny3d::Color{ 0, 0, 0, tiny3d::Color::Solid }, FragmentPoint(tiny3d::UPoint{ k & 1, k >> 1 }, i)).r;
+				}
+			}
+		}
+	};
+	static const Kernel kernel;
+	const tiny3d::WideSInt o = tiny3d::WideSInt(kernel.offset[(p.y & 1) * 2 + (p.x & 1)]);
+	return tiny3d::WideColor{
+		ClampByte_Fast(c.r + o),
+		ClampByte_Fast(c.g + o),
+		ClampByte_Fast(c.b + o),
+		c.blend
+	};
+}
+
+// @algo EncodePixels_Fast
+// @info Encodes colors to the pixel format of tiny3d::Image the same way as Image::EncodePixel.
+tiny3d::WideSInt EncodePixels_Fast(const tiny3d::WideColor &color)
+{
+	// bits = M BBBBB GGGGG RRRRR
+	constexpr int FIX_SCALAR = (32 << 8) / 255;
+	const tiny3d::WideSInt r = (color.r * tiny3d::WideSInt(FIX_SCALAR)) >> 8;
+	const tiny3d::WideSInt g = (color.g * tiny3d::WideSInt(FIX_SCALAR)) >> 8;
+	const tiny3d::WideSInt b = (color.b * tiny3d::WideSInt(FIX_SCALAR)) >> 8;
+	const tiny3d::WideSInt stencil = (color.blend & tiny3d::WideSInt(1)) << 15;
+	return stencil | (b << 10) | (g << 5) | r;
+}
+
+// @algo DecodePixels_Fast
+// @info Decodes pixels of tiny3d::Image the same way as Image::DecodePixel.
+tiny3d::WideColor DecodePixels_Fast(const tiny3d::WideSInt &pixels)
+{
+	// bits = M BBBBB GGGGG RRRRR
+	constexpr int FIX_SCALAR = (256 << 8) / 31;
+	tiny3d::WideColor color;
+	color.r     = ((pixels & tiny3d::WideSInt(0x001F)) * tiny3d::WideSInt(FIX_SCALAR)) >> 8;
+	color.g     = ((pixels & tiny3d::WideSInt(0x03E0)) * tiny3d::WideSInt(FIX_SCALAR)) >> 13;
+	color.b     = ((pixels & tiny3d::WideSInt(0x7C00)) * tiny3d::WideSInt(FIX_SCALAR)) >> 18;
+	color.blend = tiny3d::WideSInt::cmov((pixels & tiny3d::WideSInt(0x8000)) != tiny3d::WideSInt(0), tiny3d::WideSInt(int(tiny3d::Color::Solid)), tiny3d::WideSInt(int(tiny3d::Color::Transparent)));
+	return color;
+}
+
+// @algo GetColors_Fast
+// @info Decodes the colors of the pixels covered by a SIMD fragment. The pixels are laid out relative to the given coordinate according to TINY_X_OFFSETS and TINY_Y_OFFSETS.
+// @note Fragments located entirely inside of the image are loaded a row at a time. Otherwise only lanes inside of the mask are loaded, and the mask must not contain lanes outside of the image.
+// @in
+//   img -> The image to load from.
+//   p -> The coordinate of the first lane of the fragment.
+//   mask -> The lanes to load.
+// @out The colors. Lanes not loaded are zero.
+tiny3d::WideColor GetColors_Fast(const tiny3d::Image &img, tiny3d::UPoint p, const tiny3d::WideBool &mask)
+{
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	const tiny3d::UHInt *data   = internal_impl::SurfaceAccess::GetPixels(img);
+	const tiny3d::UInt   width  = internal_impl::SurfaceAccess::GetWidth(img);
+	const tiny3d::UInt   height = internal_impl::SurfaceAccess::GetHeight(img);
+
+	int pixels[TINY_WIDTH];
+	if (p.x + TINY_BLOCK_X <= width && p.y + TINY_BLOCK_Y <= height) {
+		const tiny3d::UHInt *row = data + p.x + width * p.y;
+		for (tiny3d::UInt y = 0; y < TINY_BLOCK_Y; ++y) {
+			for (tiny3d::UInt x = 0; x < TINY_BLOCK_X; ++x) {
+				pixels[x + y * TINY_BLOCK_X] = row[x];
+			}
+			row += width;
+		}
+	} else {
+		const unsigned int lanes = mask.to_bits();
+		for (int i = 0; i < TINY_WIDTH; ++i) {
+			const tiny3d::UInt j = (p.x + X_COORD_OFFSET[i]) + width * (p.y + Y_COORD_OFFSET[i]);
+			TINY3D_ASSERT(!tiny3d::TestBit(lanes, i) || j < width * height);
+			pixels[i] = tiny3d::TestBit(lanes, i) ? data[j] : 0;
+		}
+	}
+	return DecodePixels_Fast(tiny3d::WideSInt(pixels));
+}
+
+// @algo SetColors_Fast
+// @info Sets the colors of the pixels covered by a SIMD fragment. The pixels are laid out relative to the given coordinate according to TINY_X_OFFSETS and TINY_Y_OFFSETS.
+// @note The mask must not contain lanes outside of the image.
+// @in
+//   p -> The coordinate of the first lane of the fragment.
+//   color -> The colors to set.
+//   mask -> The lanes to store.
+// @inout img -> The image to store to.
+void SetColors_Fast(tiny3d::Image &img, tiny3d::UPoint p, const tiny3d::WideColor &color, const tiny3d::WideBool &mask)
+{
+	static constexpr tiny3d::SInt X_COORD_OFFSET[] = TINY_X_OFFSETS;
+	static constexpr tiny3d::SInt Y_COORD_OFFSET[] = TINY_Y_OFFSETS;
+	tiny3d::UHInt     *data   = internal_impl::SurfaceAccess::GetPixels(img);
+	const tiny3d::UInt width  = internal_impl::SurfaceAccess::GetWidth(img);
+	const tiny3d::UInt height = internal_impl::SurfaceAccess::GetHeight(img);
+
+	int pixels[TINY_WIDTH];
+	EncodePixels_Fast(color).to_scalar(pixels);
+	if (mask.all_pass() && p.x + TINY_BLOCK_X <= width && p.y + TINY_BLOCK_Y <= height) {
+		tiny3d::UHInt *row = data + p.x + width * p.y;
+		for (tiny3d::UInt y = 0; y < TINY_BLOCK_Y; ++y) {
+			for (tiny3d::UInt x = 0; x < TINY_BLOCK_X; ++x) {
+				row[x] = tiny3d::UHInt(pixels[x + y * TINY_BLOCK_X]);
+			}
+			row += width;
+		}
+	} else {
+		const unsigned int lanes = mask.to_bits();
+		for (int i = 0; i < TINY_WIDTH; ++i) {
+			if (!tiny3d::TestBit(lanes, i)) { continue; }
+			const tiny3d::UInt j = (p.x + X_COORD_OFFSET[i]) + width * (p.y + Y_COORD_OFFSET[i]);
+			TINY3D_ASSERT(j < width * height);
+			data[j] = tiny3d::UHInt(pixels[i]);
+		}
+	}
+}
+
+// @algo GetColors_Fast
+// @info Decodes the colors of a texture at the coordinates of all lanes of a SIMD fragment. Coordinates outside of the texture wrap around.
+// @note Block lookup and color decoding are done in SIMD registers. Only the loads from the compressed blocks are done per lane.
+// @in
+//   tex -> The texture.
+//   u, v -> The coordinates of the colors to get.
+// @out The colors.
+tiny3d::WideColor GetColors_Fast(const tiny3d::Texture &tex, const tiny3d::WideSInt &u, const tiny3d::WideSInt &v)
+{
+	typedef internal_impl::SurfaceAccess::CCCBlock CCCBlock;
+	static constexpr tiny3d::UInt CCC_DIM_MASK  = internal_impl::SurfaceAccess::CCC_DIM_MASK;
+	static constexpr tiny3d::UInt CCC_DIM_SHIFT = internal_impl::SurfaceAccess::CCC_DIM_SHIFT;
+	const CCCBlock *blocks = internal_impl::SurfaceAccess::GetBlocks(tex);
+
+	// NOTE: Mirrors GetIndex and DecodeTexel for all lanes at once.
+	const tiny3d::WideSInt dim_mask = tiny3d::WideSInt(int(internal_impl::SurfaceAccess::GetDimensionMask(tex)));
+	const tiny3d::WideSInt x        = u & dim_mask;
+	const tiny3d::WideSInt y        = v & dim_mask;
+
+	tiny3d::WideSInt bx = x >> CCC_DIM_SHIFT;
+	bx = (bx | (bx << 8)) & tiny3d::WideSInt(0x00FF00FF);
+	bx = (bx | (bx << 4)) & tiny3d::WideSInt(0x0F0F0F0F);
+	bx = (bx | (bx << 2)) & tiny3d::WideSInt(0x33333333);
+	bx = (bx | (bx << 1)) & tiny3d::WideSInt(0x55555555);
+
+	tiny3d::WideSInt by = y >> CCC_DIM_SHIFT;
+	by = (by | (by << 8)) & tiny3d::WideSInt(0x00FF00FF);
+	by = (by | (by << 4)) & tiny3d::WideSInt(0x0F0F0F0F);
+	by = (by | (by << 2)) & tiny3d::WideSInt(0x33333333);
+	by = (by | (by << 1)) & tiny3d::WideSInt(0x55555555);
+
+	const tiny3d::WideSInt block = bx | (by << 1);
+	const tiny3d::WideSInt bit   = (x & tiny3d::WideSInt(int(CCC_DIM_MASK))) | ((y & tiny3d::WideSInt(int(CCC_DIM_MASK))) << CCC_DIM_SHIFT);
+
+	// Gather
+#if TINY_SIMD == TINY_SIMD_AVX256 || TINY_SIMD == TINY_SIMD_AVX512
+	// NOTE: Reads 32 bits at a time, little endian. The first read holds color_idx in its lower half. The second read starts at color_idx or colors[0], so that its upper half holds the selected color without reading past the end of the block.
+	static_assert(sizeof(CCCBlock) == 3 * sizeof(tiny3d::UHInt), "CCCBlock must be packed");
+	const tiny3d::WideSInt offset    = block * tiny3d::WideSInt(int(sizeof(CCCBlock)));
+	const tiny3d::WideSInt color_idx = tiny3d::WideSInt::gather(blocks, offset) & tiny3d::WideSInt(0xFFFF);
+	const tiny3d::WideSInt select    = (color_idx >> bit) & tiny3d::WideSInt(1);
+	const tiny3d::WideSInt texel     = (tiny3d::WideSInt::gather(blocks, offset + (select << 1)) >> 16) & tiny3d::WideSInt(0xFFFF);
+#else
+	// NOTE: Backends without a gather instruction are faster reading the lanes one at a time than emulating the two gathers above.
+	int block_lanes[TINY_WIDTH];
+	int bit_lanes[TINY_WIDTH];
+	int texel_lanes[TINY_WIDTH];
+	block.to_scalar(block_lanes);
+	bit.to_scalar(bit_lanes);
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+		TINY3D_ASSERT(tiny3d::UInt(block_lanes[i]) < internal_impl::SurfaceAccess::GetBlockCount(tex));
+		const CCCBlock &b = blocks[block_lanes[i]];
+		texel_lanes[i] = b.colors[(b.color_idx >> bit_lanes[i]) & 1];
+	}
+	const tiny3d::WideSInt texel = tiny3d::WideSInt(texel_lanes);
+#endif
+
+	// Decode
+	constexpr int FIX_SCALAR = (256 << 8) / 31;
+	tiny3d::WideColor color;
+	color.r     = ((texel & tiny3d::WideSInt(0x001F)) * tiny3d::WideSInt(FIX_SCALAR)) >> 8;
+	color.g     = ((texel & tiny3d::WideSInt(0x03E0)) * tiny3d::WideSInt(FIX_SCALAR)) >> 13;
+	color.b     = ((texel & tiny3d::WideSInt(0x7C00)) * tiny3d::WideSInt(FIX_SCALAR)) >> 18;
+	color.blend = tiny3d::WideSInt::cmov((texel & tiny3d::WideSInt(0x8000)) != tiny3d::WideSInt(0), tiny3d::WideSInt(int(tex.GetBlendMode2())), tiny3d::WideSInt(int(tex.GetBlendMode1())));
+	return color;
+}
+
+// @algo Blend_Fast
+// @info Blends the texels of a SIMD fragment into the destination and writes depth. The set of blend modes is known at compile time, so only the pipelines that can not tell the blend mode beforehand need to branch per lane.
+// @in
+//   dst -> The destination color buffer.
+//   zw -> The depth value of the first lane of the fragment in the depth buffer to write to.
+//   p -> The coordinate of the first lane of the fragment.
+//   fragment_mask -> The lanes that pass coverage, depth and stencil tests.
+//   pixel -> The current colors of the destination.
+//   texel -> The texture colors.
+//   shade -> The light color the texture is modulated by. Clamped to the range of a Byte.
+//   depth -> The depth values in the format of the depth buffer.
+// @inout depth_complete -> Set to FALSE if any lane of the fragment mask does not write depth.
+template < bool depth_write, TexelBlend blend, typename depth_t, typename wide_depth_t >
+void Blend_Fast(tiny3d::Image &dst, depth_t *zw, tiny3d::UPoint p, tiny3d::WideBool fragment_mask, const tiny3d::WideColor &pixel, const tiny3d::WideColor &texel, const tiny3d::WideColor &shade, const wide_depth_t &depth, bool &depth_complete)
+{
+	if (blend == TexelBlend_None || blend == TexelBlend_Solid || blend == TexelBlend_Emissive) {
+		if (blend != TexelBlend_None) {
+			const tiny3d::WideBool opaque = texel.blend != tiny3d::WideSInt(tiny3d::Color::Transparent);
+			if (depth_write && (fragment_mask & !opaque).all_fail() == false) { depth_complete = false; }
+			fragment_mask = fragment_mask & opaque;
+			if (fragment_mask.all_fail()) { return; }
+		}
+		TINY3D_STATS_ADD(fragments_written, tiny3d::CountBits(fragment_mask.to_bits()));
+		if (blend == TexelBlend_Emissive) {
+			SetColors_Fast(dst, p, texel, fragment_mask);
+		} else {
+			SetColors_Fast(dst, p, Dither2x2_Fast(Modulate_Fast(texel, ClampBytes_Fast(shade)), p), fragment_mask);
+		}
+		if (depth_write) { StoreDepth_Fast(zw, internal_impl::SurfaceAccess::GetWidth(dst), depth, fragment_mask); }
+		return;
+	}
+
+	const unsigned int lanes = fragment_mask.to_bits();
+
+	const ColorLanes texels(texel);
+	const ColorLanes shades(ClampBytes_Fast(shade));
+	const ColorLanes pixels(pixel);
+
+	ColorLanes out;
+	bool       write[TINY_WIDTH] = { false };
+	bool       zwrite[TINY_WIDTH] = { false };
+
+	for (int i = 0; i < TINY_WIDTH; ++i) {
+
+		if (!tiny3d::TestBit(lanes, i)) { continue; }
+
+		const tiny3d::Color  t  = texels[i];
+		const tiny3d::UPoint pt = FragmentPoint(p, i);
+		TINY3D_STATS_ADD(fragments_written, t.blend != tiny3d::Color::Transparent ? 1 : 0);
+		switch (t.blend)
+		{
+		case tiny3d::Color::Solid:
+			out.Set(i, tiny3d::Dither2x2(t * shades[i], pt));
+			write[i] = zwrite[i] = true;
+			break;
+		case tiny3d::Color::AddAlpha:
+			out.Set(i, tiny3d::Dither2x2(pixels[i] + t * shades[i], pt));
+			write[i] = true;
+			break;
+		case tiny3d::Color::Emissive:
+			out.Set(i, t);
+			write[i] = zwrite[i] = true;
+			break;
+		case tiny3d::Color::EmissiveAddAlpha:
+			out.Set(i, tiny3d::Dither2x2(pixels[i] + t, pt));
+			write[i] = true;
+			break;
+		default: break;
+		}
+	}
+
+	SetColors_Fast(dst, p, out.ToWide(), tiny3d::WideBool(write));
+	if (depth_write) {
+		const tiny3d::WideBool zmask = tiny3d::WideBool(zwrite);
+		if ((zmask.to_bits() & lanes) != lanes) { depth_complete = false; }
+		StoreDepth_Fast(zw, internal_impl::SurfaceAccess::GetWidth(dst), depth, zmask);
+	}
+}
+
+// @data ColorShader_Fast
+// @info Shades SIMD fragments of a vertex colored triangle that passed the depth test. Depth read, depth write and the texture blend modes are compile time parameters, so each combination of render state gets a pipeline without dead branches.
+template < bool depth_read, bool depth_write, TexelBlend blend >
+struct ColorShader_Fast
+{
+	static constexpr bool DEPTH_READ = depth_read;
+	static constexpr bool USES_DEPTH = depth_read || depth_write;
+
+	tiny3d::Image                &dst;
+	const internal_impl::IVertex &a, &b, &c;
+	const tiny3d::Texture        *tex;
+	mutable bool                  depth_complete; // FALSE once a visible fragment is not written to the depth buffer, e.g. due to the stencil or a transparent texel
+
+	template < typename depth_t, typename wide_depth_t >
+	void operator()(tiny3d::UPoint p, depth_t *zw, tiny3d::WideBool fragment_mask, const wide_depth_t &depth, const tiny3d::WideReal &L0, const tiny3d::WideReal &L1, const tiny3d::WideReal &L2) const
+	{
+		const tiny3d::WideColor pixel = GetColors_Fast(dst, p, fragment_mask);
+
+		TINY3D_STATS_ADD(fragments_stencil_rejected, tiny3d::CountBits((fragment_mask & (pixel.blend == tiny3d::WideSInt(tiny3d::Color::Transparent))).to_bits()));
+		if (depth_write && (fragment_mask & (pixel.blend == tiny3d::WideSInt(tiny3d::Color::Transparent))).all_fail() == false) { depth_complete = false; }
+		fragment_mask = fragment_mask & (pixel.blend != tiny3d::WideSInt(tiny3d::Color::Transparent));
+
+		if (fragment_mask.all_fail()) { return; } // use transparency bit as a 1-bit stencil
+
+		TINY3D_STATS_ADD(texels_fetched, blend != TexelBlend_None ? tiny3d::CountBits(fragment_mask.to_bits()) : 0);
+
+		const tiny3d::WideColor col = {
+			tiny3d::WideSInt(tiny3d::WideReal(a.r) * L0 + tiny3d::WideReal(b.r) * L1 + tiny3d::WideReal(c.r) * L2),
+			tiny3d::WideSInt(tiny3d::WideReal(a.g) * L0 + tiny3d::WideReal(b.g) * L1 + tiny3d::WideReal(c.g) * L2),
+			tiny3d::WideSInt(tiny3d::WideReal(a.b) * L0 + tiny3d::WideReal(b.b) * L1 + tiny3d::WideReal(c.b) * L2),
+			tiny3d::WideSInt(tiny3d::Color::Solid)
+		};
+
+		tiny3d::WideColor texel = { tiny3d::WideSInt(255), tiny3d::WideSInt(255), tiny3d::WideSInt(255), tiny3d::WideSInt(tiny3d::Color::Solid) };
+		if (blend != TexelBlend_None) {
+			const tiny3d::WideSInt u = tiny3d::WideSInt(tiny3d::WideReal(a.u) * L0 + tiny3d::WideReal(b.u) * L1 + tiny3d::WideReal(c.u) * L2);
+			const tiny3d::WideSInt v = tiny3d::WideSInt(tiny3d::WideReal(a.v) * L0 + tiny3d::WideReal(b.v) * L1 + tiny3d::WideReal(c.v) * L2);
+			texel = GetColors_Fast(*tex, u, v);
+		}
+
+		Blend_Fast<depth_write, blend>(dst, zw, p, fragment_mask, pixel, texel, col, depth, depth_complete);
+	}
+};
+
+// @data LightmapShader_Fast
+// @info Shades SIMD fragments of a lightmap shaded triangle. Specialized on render state the same way as ColorShader_Fast.
+template < bool depth_read, bool depth_write, TexelBlend blend >
+struct LightmapShader_Fast
+{
+	static constexpr bool DEPTH_READ = depth_read;
+	static constexpr bool USES_DEPTH = depth_read || depth_write;
+
+	tiny3d::Image                 &dst;
+	const internal_impl::ILVertex &a, &b, &c;
+	const tiny3d::Texture         *tex;
+	const tiny3d::Texture         &lightmap;
+	mutable bool                   depth_complete; // see ColorShader_Fast
+
+	template < typename depth_t, typename wide_depth_t >
+	void operator()(tiny3d::UPoint p, depth_t *zw, tiny3d::WideBool fragment_mask, const wide_depth_t &depth, const tiny3d::WideReal &L0, const tiny3d::WideReal &L1, const tiny3d::WideReal &L2) const
+	{
+		const tiny3d::WideColor pixel = GetColors_Fast(dst, p, fragment_mask);
+
+		TINY3D_STATS_ADD(fragments_stencil_rejected, tiny3d::CountBits((fragment_mask & (pixel.blend == tiny3d::WideSInt(tiny3d::Color::Transparent))).to_bits()));
+		if (depth_write && (fragment_mask & (pixel.blend == tiny3d::WideSInt(tiny3d::Color::Transparent))).all_fail() == false) { depth_complete = false; }
+		fragment_mask = fragment_mask & (pixel.blend != tiny3d::WideSInt(tiny3d::Color::Transparent));
+
+		if (fragment_mask.all_fail()) { return; } // use transparency bit as a 1-bit stencil
+
+		TINY3D_STATS_ADD(texels_fetched, tiny3d::CountBits(fragment_mask.to_bits()) * ((blend != TexelBlend_None ? 1 : 0) + 4));
+
+		const tiny3d::WideReal lu = tiny3d::WideReal(a.lu) * L0 + tiny3d::WideReal(b.lu) * L1 + tiny3d::WideReal(c.lu) * L2;
+		const tiny3d::WideReal lv = tiny3d::WideReal(a.lv) * L0 + tiny3d::WideReal(b.lv) * L1 + tiny3d::WideReal(c.lv) * L2;
+
+		const tiny3d::WidePoint l00 = { tiny3d::WideSInt(lu),     tiny3d::WideSInt(lv)     };
+		const tiny3d::WidePoint l10 = { tiny3d::WideSInt(lu) + 1, tiny3d::WideSInt(lv)     };
+		const tiny3d::WidePoint l01 = { tiny3d::WideSInt(lu),     tiny3d::WideSInt(lv) + 1 };
+		const tiny3d::WidePoint l11 = { tiny3d::WideSInt(lu) + 1, tiny3d::WideSInt(lv) + 1 };
+		const tiny3d::WideColor c00 = GetColors_Fast(lightmap, l00.x, l00.y);
+		const tiny3d::WideColor c10 = GetColors_Fast(lightmap, l10.x, l10.y);
+		const tiny3d::WideColor c01 = GetColors_Fast(lightmap, l01.x, l01.y);
+		const tiny3d::WideColor c11 = GetColors_Fast(lightmap, l11.x, l11.y);
+
+		const tiny3d::WideColor lumel = Bilerp(
+			c00, c10,
+			c01, c11,
+			lu - tiny3d::WideReal(l00.x),
+			lv - tiny3d::WideReal(l00.y)
+		);
+
+		tiny3d::WideColor texel = { tiny3d::WideSInt(255), tiny3d::WideSInt(255), tiny3d::WideSInt(255), tiny3d::WideSInt(tiny3d::Color::Solid) };
+		if (blend != TexelBlend_None) {
+			const tiny3d::WideSInt u = tiny3d::WideSInt(tiny3d::WideReal(a.u) * L0 + tiny3d::WideReal(b.u) * L1 + tiny3d::WideReal(c.u) * L2);
+			const tiny3d::WideSInt v = tiny3d::WideSInt(tiny3d::WideReal(a.v) * L0 + tiny3d::WideReal(b.v) * L1 + tiny3d::WideReal(c.v) * L2);
+			texel = GetColors_Fast(*tex, u, v);
+		}
+
+		Blend_Fast<depth_write, blend>(dst, zw, p, fragment_mask, pixel, texel, lumel, depth, depth_complete);
+	}
+};
+
+// @algo ColorPipeline_Fast
+// @info Rasterizes a vertex colored triangle with the pipeline specialized for the render state given by the key and the perspective mode. See PipelineKey_Fast.
+template < typename depth_t, tiny3d::UInt key >
+void ColorPipeline_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::IVertex &a, const internal_impl::IVertex &b, const internal_impl::IVertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz)
+{
+	const ColorShader_Fast< (key & 1) != 0, (key & 2) != 0, TexelBlend(key >> 2) > shader = { dst, a, b, c, tex, true };
+	switch (perspective) {
+	case tiny3d::PerspectiveMode_Subdivide8:  RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Subdivide8>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);  break;
+	case tiny3d::PerspectiveMode_Subdivide16: RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Subdivide16>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader); break;
+	case tiny3d::PerspectiveMode_Affine:      RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Affine>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);      break;
+	default:                                  RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Correct>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);     break;
+	}
+}
+
+// @algo LightmapPipeline_Fast
+// @info Rasterizes a lightmap shaded triangle with the pipeline specialized for the render state given by the key and the perspective mode. See PipelineKey_Fast.
+template < typename depth_t, tiny3d::UInt key >
+void LightmapPipeline_Fast(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const internal_impl::ILVertex &a, const internal_impl::ILVertex &b, const internal_impl::ILVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz)
+{
+	const LightmapShader_Fast< (key & 1) != 0, (key & 2) != 0, TexelBlend(key >> 2) > shader = { dst, a, b, c, tex, lightmap, true };
+	switch (perspective) {
+	case tiny3d::PerspectiveMode_Subdivide8:  RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Subdivide8>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);  break;
+	case tiny3d::PerspectiveMode_Subdivide16: RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Subdivide16>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader); break;
+	case tiny3d::PerspectiveMode_Affine:      RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Affine>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);      break;
+	default:                                  RasterizeTriangle_Fast<tiny3d::PerspectiveMode_Correct>(dst, zread, zwrite, a, b, c, dst_rect, depth_format, hiz, shader);     break;
+	}
+}
+
+}
+}
+
+template < typename depth_t >
+const internal_impl::FastPipelines<depth_t> &internal_impl::TINY_SIMD_NAMESPACE::GetFastPipelines( void )
+{
+	static constexpr internal_impl::FastPipelines<depth_t> PIPELINES = {
+		{
+			ColorPipeline_Fast<depth_t, 0>,  ColorPipeline_Fast<depth_t, 1>,  ColorPipeline_Fast<depth_t, 2>,  ColorPipeline_Fast<depth_t, 3>,
+			ColorPipeline_Fast<depth_t, 4>,  ColorPipeline_Fast<depth_t, 5>,  ColorPipeline_Fast<depth_t, 6>,  ColorPipeline_Fast<depth_t, 7>,
+			ColorPipeline_Fast<depth_t, 8>,  ColorPipeline_Fast<depth_t, 9>,  ColorPipeline_Fast<depth_t, 10>, ColorPipeline_Fast<depth_t, 11>,
+			ColorPipeline_Fast<depth_t, 12>, ColorPipeline_Fast<depth_t, 13>, ColorPipeline_Fast<depth_t, 14>, ColorPipeline_Fast<depth_t, 15>
+		},
+		{
+			LightmapPipeline_Fast<depth_t, 0>,  LightmapPipeline_Fast<depth_t, 1>,  LightmapPipeline_Fast<depth_t, 2>,  LightmapPipeline_Fast<depth_t, 3>,
+			LightmapPipeline_Fast<depth_t, 4>,  LightmapPipeline_Fast<depth_t, 5>,  LightmapPipeline_Fast<depth_t, 6>,  LightmapPipeline_Fast<depth_t, 7>,
+			LightmapPipeline_Fast<depth_t, 8>,  LightmapPipeline_Fast<depth_t, 9>,  LightmapPipeline_Fast<depth_t, 10>, LightmapPipeline_Fast<depth_t, 11>,
+			LightmapPipeline_Fast<depth_t, 12>, LightmapPipeline_Fast<depth_t, 13>, LightmapPipeline_Fast<depth_t, 14>, LightmapPipeline_Fast<depth_t, 15>
+		}
+	};
+	return PIPELINES;
+}
+
+template const internal_impl::FastPipelines<float>         &internal_impl::TINY_SIMD_NAMESPACE::GetFastPipelines<float>( void );
+template const internal_impl::FastPipelines<tiny3d::UHInt> &internal_impl::TINY_SIMD_NAMESPACE::GetFastPipelines<tiny3d::UHInt>( void );
+
+TINY_SIMD_TARGET_END
+
+#endif // TINY_RASTER_FAST_H
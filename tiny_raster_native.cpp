@@ -0,0 +1,6 @@
+// NOTE: Compiles the backend of the _Fast functions for the instruction set enabled by the compiler options, unless the backends are compiled for runtime dispatch. See TINY_SIMD_DISPATCH.
+#include "tiny_simd.h"
+
+#if !TINY_SIMD_DISPATCH
+	#include "tiny_raster_fast.h"
+#endif
@@ -12,22 +12,36 @@
 #define TINY_SIMD_NEON    4
 #define TINY_SIMD_ALTIVEC 5
 
-// add support for AVX-256 and AVX-512 (#include <immintrin.h> on gcc and msvc)
 // low priority: add support for PowerPC Altivec (#include <altivec.h> on gcc)
 	// need a computer to test it on
 
+// Detect runtime dispatch support
+// The _Fast functions are compiled once for every x86 instruction set in tiny_raster_*.cpp, and the best one supported by the CPU is picked at startup. Define TINY_SIMD_NO_DISPATCH to only compile for the instruction set enabled by the compiler options.
+#if (defined(__GNUC__) && defined(__x86_64__)) || (defined(_MSC_VER) && defined(_M_X64))
+	#if !defined(TINY_FALLBACK_SCALAR) && !defined(TINY_SIMD_NO_DISPATCH)
+		#define TINY_SIMD_DISPATCH 1
+	#endif
+#endif
+#ifndef TINY_SIMD_DISPATCH
+	#define TINY_SIMD_DISPATCH 0
+#endif
+
 // Detect instruction set
 #if defined(__GNUC__)
 	#define TINY_COMPILER TINY_COMPILER_GCC
 	#ifdef TINY_FALLBACK_SCALAR
 		#define TINY_SIMD TINY_SIMD_NONE
-	#elif defined(__AVX__)
-		#define TINY_SIMD TINY_SIMD_AVX256
-		#ifdef __AVX2__
-			#define TINY_SIMD_VER 2
-		#endif
-	#elif defined(__AVX512__)
+	#elif defined(TINY_SIMD_TARGET) && TINY_SIMD_DISPATCH
+		// One of the SIMD backends compiled for runtime dispatch, see tiny_cpu.h
+		#define TINY_SIMD TINY_SIMD_TARGET
+		#define TINY_SIMD_VER 2
+	#elif defined(__AVX512F__)
+		// AVX-512 targets also define the AVX2 macros, so test for AVX-512 first
 		#define TINY_SIMD TINY_SIMD_AVX512
+	#elif defined(__AVX2__)
+		// 256-bit integer instructions require AVX2, so AVX alone falls back to SSE
+		#define TINY_SIMD TINY_SIMD_AVX256
+		#define TINY_SIMD_VER 2
 	#elif defined(__SSE__)
 		#define TINY_SIMD  TINY_SIMD_SSE
 		#ifdef __SSE4__
@@ -54,8 +68,16 @@
 	#define TINY_COMPILER TINY_COMPILER_MSVC
 	#ifdef TINY_FALLBACK_SCALAR
 		#define TINY_SIMD TINY_SIMD_NONE
+	#elif defined(TINY_SIMD_TARGET) && TINY_SIMD_DISPATCH
+		#define TINY_SIMD TINY_SIMD_TARGET
+		#define TINY_SIMD_VER 2
+	#elif defined(__AVX512F__)
+		#define TINY_SIMD TINY_SIMD_AVX512
+	#elif defined(__AVX2__)
+		#define TINY_SIMD TINY_SIMD_AVX256
+		#define TINY_SIMD_VER 2
 	#elif !defined(_M_CEE_PURE)
-		#define TINY_SIMD TINY_SSE
+		#define TINY_SIMD TINY_SIMD_SSE
 	#else
 		#define TINY_SIMD TINY_SIMD_NONE
 		#warning No SIMD support, falling back to scalar
@@ -72,6 +94,7 @@
 
 // SIMD instruction definitions
 #if TINY_SIMD == TINY_SIMD_SSE
+	#define TINY_SIMD_NAMESPACE simd_sse
 	#define TINY_WIDTH         4
 	#define TINY_BYTE_ALIGN    16
 	#define TINY_BLOCK_X       2
@@ -81,6 +104,7 @@
 	#define TINY_X_OFFSETS     { 0, 1, 0, 1 }
 	#define TINY_Y_OFFSETS     { 0, 0, 1, 1 }
 #elif TINY_SIMD == TINY_SIMD_NEON
+	#define TINY_SIMD_NAMESPACE simd_neon
 	#define TINY_WIDTH         4
 	#define TINY_BYTE_ALIGN    16
 	#define TINY_BLOCK_X       2
@@ -90,6 +114,7 @@
 	#define TINY_X_OFFSETS     { 0, 1, 0, 1 }
 	#define TINY_Y_OFFSETS     { 0, 0, 1, 1 }
 #elif TINY_SIMD == TINY_SIMD_AVX256
+	#define TINY_SIMD_NAMESPACE simd_avx2
 	#define TINY_WIDTH         8
 	#define TINY_BYTE_ALIGN    32
 	#define TINY_BLOCK_X       4
@@ -99,6 +124,7 @@
 	#define TINY_X_OFFSETS     { 0, 1, 2, 3, 0, 1, 2, 3 }
 	#define TINY_Y_OFFSETS     { 0, 0, 0, 0, 1, 1, 1, 1 }
 #elif TINY_SIMD == TINY_SIMD_AVX512
+	#define TINY_SIMD_NAMESPACE simd_avx512
 	#define TINY_WIDTH         16
 	#define TINY_BYTE_ALIGN    64
 	#define TINY_BLOCK_X       4
@@ -108,6 +134,7 @@
 	#define TINY_X_OFFSETS     { 0, 1, 2, 3, 0, 1, 2, 3, 0, 1,  2,  3,  0,  1,  2,  3 }
 	#define TINY_Y_OFFSETS     { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2,  2,  2,  3,  3,  3,  3 }
 #elif TINY_SIMD == TINY_SIMD_ALTIVEC
+	#define TINY_SIMD_NAMESPACE simd_altivec
 	#define TINY_WIDTH         4
 	#define TINY_BYTE_ALIGN    16
 	#define TINY_BLOCK_X       2
@@ -117,6 +144,7 @@
 	#define TINY_X_OFFSETS     { 0, 1, 0, 1 }
 	#define TINY_Y_OFFSETS     { 0, 0, 1, 1 }
 #elif TINY_SIMD == TINY_SIMD_NONE
+	#define TINY_SIMD_NAMESPACE simd_none
 	#define TINY_WIDTH         1
 	#define TINY_BYTE_ALIGN    1
 	#define TINY_BLOCK_X       1
@@ -138,14 +166,28 @@
 #define TINY_FLOOR(X)        ((X) & TINY_WIDTH_INVMASK)
 #define TINY_CEIL(X)         TINY_FLOOR((X) + TINY_WIDTH_MASK)
 
+#include <cmath>
+#include <cstring>
+
 // Include appropriate headers
 // Some notes,
 // Catchall include for MSVC is "#include <intrin.h>"
 // Catchall include for GCC is "#include <x86intrin.h>"
-#if TINY_SIMD == TINY_SIMD_AVX256 || TINY_SIMD == TINY_SIMD_AVX512
+#if TINY_SIMD == TINY_SIMD_AVX512 && TINY_COMPILER == TINY_COMPILER_GCC
+	// g++ 12 warns about uninitialized values inside of the AVX-512 intrinsics (gcc bug 105593)
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wuninitialized"
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+	#include <immintrin.h>
+	#pragma GCC diagnostic pop
+#elif TINY_SIMD == TINY_SIMD_AVX256 || TINY_SIMD == TINY_SIMD_AVX512
 	#include <immintrin.h>
 #elif TINY_SIMD == TINY_SIMD_SSE
-	#include <xmmintrin.h>
+	#if TINY_SIMD_VER >= 4
+		#include <smmintrin.h>
+	#else
+		#include <xmmintrin.h>
+	#endif
 #elif TINY_SIMD == TINY_SIMD_NEON
 	#include <arm_neon.h>
 #elif TINY_SIMD == TINY_SIMD_ALTIVEC
@@ -156,6 +198,28 @@
 	#undef bool
 #endif
 
+// Enable the instruction set of a SIMD backend compiled for runtime dispatch for the functions between TINY_SIMD_TARGET_BEGIN and TINY_SIMD_TARGET_END
+// Only the functions of the backend may be compiled for it, since the linker may pick any copy of a function defined in several translation units
+#if defined(TINY_SIMD_TARGET) && TINY_SIMD_DISPATCH && TINY_COMPILER == TINY_COMPILER_GCC && TINY_SIMD != TINY_SIMD_SSE
+	#if defined(__clang__) && TINY_SIMD == TINY_SIMD_AVX512
+		#define TINY_SIMD_TARGET_BEGIN _Pragma("clang attribute push (__attribute__((target(\"avx512f\"))), apply_to = function)")
+	#elif defined(__clang__)
+		#define TINY_SIMD_TARGET_BEGIN _Pragma("clang attribute push (__attribute__((target(\"avx2\"))), apply_to = function)")
+	#elif TINY_SIMD == TINY_SIMD_AVX512
+		#define TINY_SIMD_TARGET_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f\")")
+	#else
+		#define TINY_SIMD_TARGET_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx2\")")
+	#endif
+	#if defined(__clang__)
+		#define TINY_SIMD_TARGET_END _Pragma("clang attribute pop")
+	#else
+		#define TINY_SIMD_TARGET_END _Pragma("GCC pop_options")
+	#endif
+#else
+	#define TINY_SIMD_TARGET_BEGIN
+	#define TINY_SIMD_TARGET_END
+#endif
+
 #if ((-2 >> 1) == (-2 / 2)) && ((-2 << 1) == (-2 * 2))
 	#define TINY_SIGNED_SHIFT 1
 #endif
@@ -165,7 +229,12 @@
 #define TINY_FALSE_BITS 0
 
 
+TINY_SIMD_TARGET_BEGIN
+
 namespace tiny3d
+{
+// The wide types of every backend live in a namespace of their own, so that the backends compiled for runtime dispatch can be linked together
+inline namespace TINY_SIMD_NAMESPACE
 {
 
 	class WideReal;
@@ -221,6 +290,9 @@ namespace tiny3d
 		bool all_fail( void ) const { return _mm_movemask_epi8(u) == 0x0000; }
 		bool all_pass( void ) const { return _mm_movemask_epi8(u) == 0xffff; }
 
+		// NOTE: Bit i is set if lane i passes.
+		unsigned int to_bits( void ) const { return unsigned(_mm_movemask_ps(f)); }
+
 		operator bool( void ) const { return !all_fail(); }
 	}
 	#if TINY_COMPILER == TINY_COMPILER_GCC
@@ -289,7 +361,7 @@ namespace tiny3d
 
 		static WideReal cmov(const WideBool &cond_mask, const WideReal &l, const WideReal &r)
 		{
-#if TINY_SIMD_VER < 2
+#if TINY_SIMD_VER < 4
 			WideBool l_mask;
 			l_mask.u = _mm_andnot_si128(cond_mask.u, _mm_set1_epi32(TINY_UNS_MAX));
 			__m128 rc, lc;
@@ -298,9 +370,8 @@ namespace tiny3d
 			rc = _mm_or_ps(rc, lc);
 			return rc;
 #else
-			__m128 ret = r.f;
-			_mm_maskmoveu_si128(*reinterpret_cast<const __m128i*>(&l), cond_mask.u, reinterpret_cast<char*>(&ret));
-			return ret;
+			// NOTE: _mm_maskmoveu_si128 is a non-temporal store to memory and is much slower than masking in registers.
+			return _mm_blendv_ps(r.f, l.f, cond_mask.f);
 #endif
 		}
 		static WideReal max(const WideReal &a, const WideReal &b) { return _mm_max_ps(a.f, b.f); }
@@ -384,7 +455,7 @@ namespace tiny3d
 
 		static wide_fixed<n> cmov(const WideBool &cond_mask, const wide_fixed<n> &l, const wide_fixed<n> &r)
 		{
-#if TINY_SIMD_VER < 2
+#if TINY_SIMD_VER < 4
 			__m128i l_mask;
 			l_mask = _mm_andnot_si128(cond_mask.u, _mm_set1_epi32(TINY_UNS_MAX));
 			__m128i rc, lc;
@@ -393,9 +464,7 @@ namespace tiny3d
 			rc = _mm_or_si128(rc, lc);
 			return rc;
 #else
-			__m128i ret = r.i;
-			_mm_maskmoveu_si128(l.i, cond_mask.u, reinterpret_cast<char*>(&ret));
-			return ret;
+			return _mm_blendv_epi8(r.i, l.i, cond_mask.u);
 #endif
 		}
 		static wide_fixed<n> max(const wide_fixed<n> &a, const wide_fixed<n> &b)
@@ -444,6 +513,11 @@ namespace tiny3d
 		WideSInt(int val) : i(_mm_set1_epi32(val)) {}
 		WideSInt(bool val) : i(_mm_set1_epi32(val ? 1 : 0)) {}
 		explicit WideSInt(const int *in) : i(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))) {}
+#if TINY_SIMD_VER < 4
+		explicit WideSInt(const unsigned short *in) : i(_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)), _mm_setzero_si128())) {}
+#else
+		explicit WideSInt(const unsigned short *in) : i(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)))) {}
+#endif
 		template < int n >
 		inline explicit WideSInt(const wide_fixed<n> &f);
 		inline explicit WideSInt(const WideReal &r);
@@ -480,6 +554,7 @@ namespace tiny3d
 		WideSInt operator&(const WideBool &r) const { return _mm_and_si128(i, r.u); }
 		WideSInt operator<<(int r) const { return _mm_slli_epi32(i, r); }
 		WideSInt operator>>(int r) const { return _mm_srai_epi32(i, r); }
+		WideSInt operator>>(const WideSInt &r) const { int a[TINY_WIDTH], b[TINY_WIDTH]; to_scalar(a); r.to_scalar(b); for (int j = 0; j < TINY_WIDTH; ++j) { a[j] >>= b[j]; } return WideSInt(a); }
 //		WideSInt operator/(const WideSInt &r) { WideSInt o = *this; return o /= r; }
 //		WideSInt operator%(const WideSInt &r) { return *this - (*this / r) * r; } // NOTE: May not work for negative numbers. Abs?
 
@@ -494,7 +569,7 @@ namespace tiny3d
 
 		static WideSInt cmov(const WideBool &cond_mask, const WideSInt &l, const WideSInt &r)
 		{
-#if TINY_SIMD_VER < 2
+#if TINY_SIMD_VER < 4
 			__m128i l_mask;
 			l_mask = _mm_andnot_si128(cond_mask.u, _mm_set1_epi32(TINY_UNS_MAX));
 			__m128i rc, lc;
@@ -503,9 +578,7 @@ namespace tiny3d
 			rc = _mm_or_si128(rc, lc);
 			return rc;
 #else
-			__m128i ret = r.i;
-			_mm_maskmoveu_si128(l.i, cond_mask.u, reinterpret_cast<char*>(&ret));
-			return ret;
+			return _mm_blendv_epi8(r.i, l.i, cond_mask.u);
 #endif
 		}
 		static WideSInt max(const WideSInt &a, const WideSInt &b)
@@ -525,6 +598,14 @@ namespace tiny3d
 			return _mm_min_epi32(a.i, b.i);
 #endif
 		}
+		// NOTE: Loads the 32-bit value at base plus the byte offset of each lane.
+		static WideSInt gather(const void *base, const WideSInt &offsets)
+		{
+			int o[TINY_WIDTH], out[TINY_WIDTH];
+			offsets.to_scalar(o);
+			for (int j = 0; j < TINY_WIDTH; ++j) { std::memcpy(out + j, static_cast<const char*>(base) + o[j], sizeof(int)); }
+			return WideSInt(out);
+		}
 	}
 	#if TINY_COMPILER == TINY_COMPILER_GCC
 		__attribute__((aligned(TINY_BYTE_ALIGN)))
@@ -548,11 +629,579 @@ namespace tiny3d
 
 #elif TINY_SIMD == TINY_SIMD_AVX256
 
-	// __m256, __m256i
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	union WideBool
+	{
+		friend class WideReal;
+		friend class WideSInt;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__m256  f;
+		__m256i u;
+
+	private:
+		WideBool(const __m256i &r) : u(r) {}
+		WideBool(const __m256 &r) : f(r) {}
+
+	public:
+		typedef bool scalar_t;
+		typedef bool vector_t[TINY_WIDTH];
+
+		WideBool( void ) {}
+		WideBool(const WideBool &b) : f(b.f) {}
+		WideBool(bool b) : u(_mm256_set1_epi32(b ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS))) {}
+		WideBool(const bool *b) : u(_mm256_setr_epi32(
+			b[0] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[1] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[2] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[3] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS),
+			b[4] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[5] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[6] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS), b[7] ? int(TINY_TRUE_BITS) : int(TINY_FALSE_BITS))) {}
+
+		WideBool &operator=(const WideBool&) = default;
+
+		WideBool operator||(const WideBool &r) const { return _mm256_or_si256(u, r.u);  }
+		WideBool operator&&(const WideBool &r) const { return _mm256_and_si256(u, r.u); }
+
+		WideBool operator|(const WideBool &r) const { return _mm256_or_si256(u, r.u);  }
+		WideBool operator&(const WideBool &r) const { return _mm256_and_si256(u, r.u); }
+
+		WideBool operator!( void ) const { return _mm256_xor_si256(u, _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+
+		// NOTE: Lanes are either all true or all false bits, so the sign bit of each lane is enough.
+		bool all_fail( void ) const { return _mm256_movemask_ps(f) == 0x00; }
+		bool all_pass( void ) const { return _mm256_movemask_ps(f) == 0xff; }
+
+		unsigned int to_bits( void ) const { return unsigned(_mm256_movemask_ps(f)); }
+
+		operator bool( void ) const { return !all_fail(); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	class WideReal
+	{
+		friend class WideSInt;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__m256 f;
+
+	private:
+		WideReal(const __m256 &r) : f(r) {}
+
+	public:
+		typedef float scalar_t;
+		typedef float vector_t[TINY_WIDTH];
+
+		WideReal( void ) {}
+		WideReal(const WideReal &r) : f(r.f) {}
+		WideReal(float val) : f(_mm256_set1_ps(val)) {}
+		WideReal(bool val) : f(_mm256_set1_ps(val ? 1.0f : 0.0f)) {}
+		explicit WideReal(const float *in) : f(_mm256_loadu_ps(in)) {}
+		inline explicit WideReal(const WideSInt &r);
+		inline explicit WideReal(const WideBool &r);
+
+		WideReal &operator=(const WideReal&) = default;
+		WideReal &operator=(const cset<WideReal> &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		WideReal operator-( void ) const { return WideReal(0.0f) - *this; }
+
+		WideReal &operator+=(const WideReal &r) { f = _mm256_add_ps(f, r.f); return *this; }
+		WideReal &operator-=(const WideReal &r) { f = _mm256_sub_ps(f, r.f); return *this; }
+		WideReal &operator*=(const WideReal &r) { f = _mm256_mul_ps(f, r.f); return *this; }
+		WideReal &operator/=(const WideReal &r) { f = _mm256_div_ps(f, r.f); return *this; }
+		WideReal &operator|=(const WideReal &r) { f = _mm256_or_ps(f, r.f);  return *this; }
+		WideReal &operator|=(const WideBool &r)  { f = _mm256_or_ps(f, r.f);  return *this; }
+		WideReal &operator&=(const WideReal &r) { f = _mm256_and_ps(f, r.f); return *this; }
+		WideReal &operator&=(const WideBool &r)  { f = _mm256_and_ps(f, r.f); return *this; }
+
+		WideReal operator+(const WideReal &r) const { return _mm256_add_ps(f, r.f); }
+		WideReal operator-(const WideReal &r) const { return _mm256_sub_ps(f, r.f); }
+		WideReal operator*(const WideReal &r) const { return _mm256_mul_ps(f, r.f); }
+		WideReal operator/(const WideReal &r) const { return _mm256_div_ps(f, r.f); }
+		WideReal operator|(const WideReal &r) const { return _mm256_or_ps(f, r.f);  }
+		WideReal operator|(const WideBool &r)  const { return _mm256_or_ps(f, r.f);  }
+		WideReal operator&(const WideReal &r) const { return _mm256_and_ps(f, r.f); }
+		WideReal operator&(const WideBool &r)  const { return _mm256_and_ps(f, r.f); }
+
+		// NOTE: The predicates match the SSE comparisons, i.e. only != is true for NaN.
+		WideBool operator==(const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_EQ_OQ);  }
+		WideBool operator!=(const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_NEQ_UQ); }
+		WideBool operator< (const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_LT_OS);  }
+		WideBool operator<=(const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_LE_OS);  }
+		WideBool operator> (const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_GT_OS);  }
+		WideBool operator>=(const WideReal &r) const { return _mm256_cmp_ps(f, r.f, _CMP_GE_OS);  }
+
+		void to_scalar(float *out) const { _mm256_storeu_ps(out, f); }
+
+		static WideReal cmov(const WideBool &cond_mask, const WideReal &l, const WideReal &r) { return _mm256_blendv_ps(r.f, l.f, cond_mask.f); }
+		static WideReal max(const WideReal &a, const WideReal &b) { return _mm256_max_ps(a.f, b.f); }
+		static WideReal min(const WideReal &a, const WideReal &b) { return _mm256_min_ps(a.f, b.f); }
+		static WideReal sqrt(const WideReal &x)                     { return _mm256_sqrt_ps(x.f); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	template < int n >
+	class wide_fixed
+	{
+		friend class WideSInt;
+
+	private:
+		__m256i i;
+
+	private:
+		wide_fixed(const __m256i &r) : i(r) {}
+
+	public:
+#ifdef MML_FIXED_H_INCLUDED__
+		typedef mml::fixed<int, n> scalar_t;
+		typedef mml::fixed<int, n> vector_t[TINY_WIDTH];
+#else
+		typedef int scalar_t;
+		typedef int vector_t[TINY_WIDTH];
+#endif
+
+		wide_fixed( void ) {}
+		wide_fixed(const wide_fixed<n> &r) : i(r.i) {}
+		wide_fixed(int val) : i(_mm256_slli_epi32(_mm256_set1_epi32(val), n)) {}
+		wide_fixed(float val) : i(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_set1_ps(val), _mm256_set1_ps(1 << n)))) {}
+		wide_fixed(bool val) : i(_mm256_slli_epi32(_mm256_set1_epi32(val ? 1 : 0), n)) {}
+		explicit wide_fixed(const int *in) : i(_mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)), n)) {}
+		explicit wide_fixed(const float *in) : i(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in), _mm256_set1_ps(1 << n)))) {}
+		inline explicit wide_fixed(const WideSInt &r);
+		inline explicit wide_fixed(const WideReal &r);
+		inline explicit wide_fixed(const WideBool &r);
+
+		wide_fixed<n> &operator=(const wide_fixed<n>&) = default;
+		wide_fixed<n> &operator=(const cset< wide_fixed<n> > &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		wide_fixed<n> operator-( void ) const { return wide_fixed<n>(0) - *this; }
+
+		wide_fixed<n> &operator+=(const wide_fixed<n> &r) { i = _mm256_add_epi32(i, r.i); return *this; }
+		wide_fixed<n> &operator-=(const wide_fixed<n> &r) { i = _mm256_sub_epi32(i, r.i); return *this; }
+		wide_fixed<n> &operator*=(const wide_fixed<n> &r) { i = _mm256_srai_epi32(_mm256_mullo_epi32(i, r.i), n); return *this; }
+		wide_fixed<n> &operator|=(const wide_fixed<n> &r) { i = _mm256_or_si256(i, r.i); return *this; }
+		wide_fixed<n> &operator|=(const WideBool &r)     { i = _mm256_or_si256(i, r.u); return *this; }
+		wide_fixed<n> &operator&=(const wide_fixed<n> &r) { i = _mm256_and_si256(i, r.i); return *this; }
+		wide_fixed<n> &operator&=(const WideBool &r)     { i = _mm256_and_si256(i, r.u); return *this; }
+
+		wide_fixed<n> operator+(const wide_fixed<n> &r) const { return _mm256_add_epi32(i, r.i); }
+		wide_fixed<n> operator-(const wide_fixed<n> &r) const { return _mm256_sub_epi32(i, r.i); }
+		wide_fixed<n> operator*(const wide_fixed<n> &r) const { wide_fixed<n> o; o.i = i; o *= r; return o; }
+		wide_fixed<n> operator|(const wide_fixed<n> &r) const { return _mm256_or_si256(i, r.i);  }
+		wide_fixed<n> operator|(const WideBool &r)     const { return _mm256_or_si256(i, r.u);  }
+		wide_fixed<n> operator&(const wide_fixed<n> &r) const { return _mm256_and_si256(i, r.i); }
+		wide_fixed<n> operator&(const WideBool &r)     const { return _mm256_and_si256(i, r.u); }
+
+		WideBool operator==(const wide_fixed<n> &r) const { return _mm256_cmpeq_epi32(i, r.i); }
+		WideBool operator!=(const wide_fixed<n> &r) const { return _mm256_andnot_si256(_mm256_cmpeq_epi32(i, r.i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+		WideBool operator< (const wide_fixed<n> &r) const { return _mm256_cmpgt_epi32(r.i, i); }
+		WideBool operator<=(const wide_fixed<n> &r) const { return _mm256_andnot_si256(_mm256_cmpgt_epi32(i, r.i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+		WideBool operator> (const wide_fixed<n> &r) const { return _mm256_cmpgt_epi32(i, r.i); }
+		WideBool operator>=(const wide_fixed<n> &r) const { return _mm256_andnot_si256(_mm256_cmpgt_epi32(r.i, i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+
+		void to_scalar(int *out) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_srai_epi32(i, n)); }
+
+		static wide_fixed<n> cmov(const WideBool &cond_mask, const wide_fixed<n> &l, const wide_fixed<n> &r) { return _mm256_blendv_epi8(r.i, l.i, cond_mask.u); }
+		static wide_fixed<n> max(const wide_fixed<n> &a, const wide_fixed<n> &b) { return _mm256_max_epi32(a.i, b.i); }
+		static wide_fixed<n> min(const wide_fixed<n> &a, const wide_fixed<n> &b) { return _mm256_min_epi32(a.i, b.i); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	class WideSInt
+	{
+		friend class WideReal;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__m256i i;
+
+	private:
+		WideSInt(const __m256i &r) : i(r) {}
+
+	public:
+		typedef int scalar_t;
+		typedef int vector_t[TINY_WIDTH];
+
+		WideSInt( void ) {}
+		WideSInt(const WideSInt &r) : i(r.i) {}
+		WideSInt(int val) : i(_mm256_set1_epi32(val)) {}
+		WideSInt(bool val) : i(_mm256_set1_epi32(val ? 1 : 0)) {}
+		explicit WideSInt(const int *in) : i(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in))) {}
+		explicit WideSInt(const unsigned short *in) : i(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)))) {}
+		template < int n >
+		inline explicit WideSInt(const wide_fixed<n> &f);
+		inline explicit WideSInt(const WideReal &r);
+		inline explicit WideSInt(const WideBool &r);
+
+		WideSInt &operator=(const WideSInt&) = default;
+		WideSInt &operator=(const cset<WideSInt> &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		WideSInt operator-( void ) const { return WideSInt(0) - *this; }
+
+		WideSInt &operator+=(const WideSInt &r) { i = _mm256_add_epi32(i, r.i); return *this; }
+		WideSInt &operator-=(const WideSInt &r) { i = _mm256_sub_epi32(i, r.i); return *this; }
+		WideSInt &operator*=(const WideSInt &r) { i = _mm256_mullo_epi32(i, r.i); return *this; }
+		WideSInt &operator|=(const WideSInt &r)  { i = _mm256_or_si256(i, r.i);  return *this; }
+		WideSInt &operator|=(const WideBool &r) { i = _mm256_or_si256(i, r.u);  return *this; }
+		WideSInt &operator&=(const WideSInt &r)  { i = _mm256_and_si256(i, r.i); return *this; }
+		WideSInt &operator&=(const WideBool &r) { i = _mm256_and_si256(i, r.u); return *this; }
+		WideSInt &operator<<=(int r) { i = _mm256_slli_epi32(i, r); return *this; }
+		WideSInt &operator>>=(int r) { i = _mm256_srai_epi32(i, r); return *this; }
+
+		WideSInt operator+(const WideSInt &r)  const { return _mm256_add_epi32(i, r.i); }
+		WideSInt operator-(const WideSInt &r)  const { return _mm256_sub_epi32(i, r.i); }
+		WideSInt operator*(const WideSInt &r)  const { return _mm256_mullo_epi32(i, r.i); }
+		WideSInt operator|(const WideSInt &r)  const { return _mm256_or_si256(i, r.i);  }
+		WideSInt operator|(const WideBool &r) const { return _mm256_or_si256(i, r.u);  }
+		WideSInt operator&(const WideSInt &r)  const { return _mm256_and_si256(i, r.i); }
+		WideSInt operator&(const WideBool &r) const { return _mm256_and_si256(i, r.u); }
+		WideSInt operator<<(int r) const { return _mm256_slli_epi32(i, r); }
+		WideSInt operator>>(int r) const { return _mm256_srai_epi32(i, r); }
+		WideSInt operator>>(const WideSInt &r) const { return _mm256_srav_epi32(i, r.i); }
+
+		WideBool operator==(const WideSInt &r) const { return _mm256_cmpeq_epi32(i, r.i); }
+		WideBool operator!=(const WideSInt &r) const { return _mm256_andnot_si256(_mm256_cmpeq_epi32(i, r.i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+		WideBool operator< (const WideSInt &r) const { return _mm256_cmpgt_epi32(r.i, i); }
+		WideBool operator<=(const WideSInt &r) const { return _mm256_andnot_si256(_mm256_cmpgt_epi32(i, r.i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+		WideBool operator> (const WideSInt &r) const { return _mm256_cmpgt_epi32(i, r.i); }
+		WideBool operator>=(const WideSInt &r) const { return _mm256_andnot_si256(_mm256_cmpgt_epi32(r.i, i), _mm256_set1_epi32(int(TINY_TRUE_BITS))); }
+
+		void to_scalar(int *out) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), i); }
+
+		static WideSInt cmov(const WideBool &cond_mask, const WideSInt &l, const WideSInt &r) { return _mm256_blendv_epi8(r.i, l.i, cond_mask.u); }
+		static WideSInt max(const WideSInt &a, const WideSInt &b) { return _mm256_max_epi32(a.i, b.i); }
+		static WideSInt min(const WideSInt &a, const WideSInt &b) { return _mm256_min_epi32(a.i, b.i); }
+		static WideSInt gather(const void *base, const WideSInt &offsets) { return _mm256_i32gather_epi32(static_cast<const int*>(base), offsets.i, 1); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	WideReal::WideReal(const WideSInt &r) : f(_mm256_cvtepi32_ps(r.i)) {}
+	WideReal::WideReal(const WideBool &r) : WideReal(WideReal::cmov(r, WideReal(1.0f), WideReal(0.0f))) {}
+
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideSInt &r) : i(_mm256_slli_epi32(r.i, n)) {}
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideReal &r) : i(_mm256_cvttps_epi32(_mm256_mul_ps(r.f, _mm256_set1_ps(1 << n)))) {}
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideBool &r) : wide_fixed(wide_fixed<n>::cmov(r, wide_fixed<n>(WideSInt(1)), wide_fixed<n>(WideSInt(0)))) {}
+
+	WideSInt::WideSInt(const WideReal &r)   : i(_mm256_cvttps_epi32(r.f)) {}
+	template < int n >
+	WideSInt::WideSInt(const wide_fixed<n> &r) : i(_mm256_srai_epi32(r.i, n)) {}
+	WideSInt::WideSInt(const WideBool &r) : WideSInt(WideSInt::cmov(r, WideSInt(1), WideSInt(0))) {}
 
 #elif TINY_SIMD == TINY_SIMD_AVX512
 
-	// __m512, __m512i
+	// NOTE: Masks live in the k registers rather than in vector registers, one bit per lane.
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	union WideBool
+	{
+		friend class WideReal;
+		friend class WideSInt;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__mmask16 m;
+
+	private:
+		WideBool(__mmask16 r) : m(r) {}
+
+	public:
+		typedef bool scalar_t;
+		typedef bool vector_t[TINY_WIDTH];
+
+		WideBool( void ) {}
+		WideBool(const WideBool &b) : m(b.m) {}
+		WideBool(bool b) : m(b ? __mmask16(0xffff) : __mmask16(0x0000)) {}
+		WideBool(const bool *b) : m(0) {
+			for (int i = 0; i < TINY_WIDTH; ++i) {
+				if (b[i]) { m |= __mmask16(1 << i); }
+			}
+		}
+
+		WideBool &operator=(const WideBool&) = default;
+
+		WideBool operator||(const WideBool &r) const { return _mm512_kor(m, r.m);  }
+		WideBool operator&&(const WideBool &r) const { return _mm512_kand(m, r.m); }
+
+		WideBool operator|(const WideBool &r) const { return _mm512_kor(m, r.m);  }
+		WideBool operator&(const WideBool &r) const { return _mm512_kand(m, r.m); }
+
+		WideBool operator!( void ) const { return _mm512_knot(m); }
+
+		bool all_fail( void ) const { return m == 0x0000; }
+		bool all_pass( void ) const { return m == 0xffff; }
+
+		unsigned int to_bits( void ) const { return m; }
+
+		operator bool( void ) const { return !all_fail(); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	class WideReal
+	{
+		friend class WideSInt;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__m512 f;
+
+	private:
+		WideReal(const __m512 &r) : f(r) {}
+
+		static __m512 or_mask(const __m512 &f, __mmask16 m) { return _mm512_castsi512_ps(_mm512_mask_mov_epi32(_mm512_castps_si512(f), m, _mm512_set1_epi32(int(TINY_TRUE_BITS)))); }
+
+	public:
+		typedef float scalar_t;
+		typedef float vector_t[TINY_WIDTH];
+
+		WideReal( void ) {}
+		WideReal(const WideReal &r) : f(r.f) {}
+		WideReal(float val) : f(_mm512_set1_ps(val)) {}
+		WideReal(bool val) : f(_mm512_set1_ps(val ? 1.0f : 0.0f)) {}
+		explicit WideReal(const float *in) : f(_mm512_loadu_ps(in)) {}
+		inline explicit WideReal(const WideSInt &r);
+		inline explicit WideReal(const WideBool &r);
+
+		WideReal &operator=(const WideReal&) = default;
+		WideReal &operator=(const cset<WideReal> &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		WideReal operator-( void ) const { return WideReal(0.0f) - *this; }
+
+		WideReal &operator+=(const WideReal &r) { f = _mm512_add_ps(f, r.f); return *this; }
+		WideReal &operator-=(const WideReal &r) { f = _mm512_sub_ps(f, r.f); return *this; }
+		WideReal &operator*=(const WideReal &r) { f = _mm512_mul_ps(f, r.f); return *this; }
+		WideReal &operator/=(const WideReal &r) { f = _mm512_div_ps(f, r.f); return *this; }
+		WideReal &operator|=(const WideReal &r) { f = _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(f), _mm512_castps_si512(r.f)));  return *this; }
+		WideReal &operator|=(const WideBool &r)  { f = or_mask(f, r.m);             return *this; }
+		WideReal &operator&=(const WideReal &r) { f = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(f), _mm512_castps_si512(r.f))); return *this; }
+		WideReal &operator&=(const WideBool &r)  { f = _mm512_maskz_mov_ps(r.m, f); return *this; }
+
+		WideReal operator+(const WideReal &r) const { return _mm512_add_ps(f, r.f); }
+		WideReal operator-(const WideReal &r) const { return _mm512_sub_ps(f, r.f); }
+		WideReal operator*(const WideReal &r) const { return _mm512_mul_ps(f, r.f); }
+		WideReal operator/(const WideReal &r) const { return _mm512_div_ps(f, r.f); }
+		WideReal operator|(const WideReal &r) const { WideReal o = *this; return o |= r; }
+		WideReal operator|(const WideBool &r)  const { return or_mask(f, r.m); }
+		WideReal operator&(const WideReal &r) const { WideReal o = *this; return o &= r; }
+		WideReal operator&(const WideBool &r)  const { return _mm512_maskz_mov_ps(r.m, f); }
+
+		// NOTE: The predicates match the SSE comparisons, i.e. only != is true for NaN.
+		WideBool operator==(const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_EQ_OQ);  }
+		WideBool operator!=(const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_NEQ_UQ); }
+		WideBool operator< (const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_LT_OS);  }
+		WideBool operator<=(const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_LE_OS);  }
+		WideBool operator> (const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_GT_OS);  }
+		WideBool operator>=(const WideReal &r) const { return _mm512_cmp_ps_mask(f, r.f, _CMP_GE_OS);  }
+
+		void to_scalar(float *out) const { _mm512_storeu_ps(out, f); }
+
+		static WideReal cmov(const WideBool &cond_mask, const WideReal &l, const WideReal &r) { return _mm512_mask_blend_ps(cond_mask.m, r.f, l.f); }
+		static WideReal max(const WideReal &a, const WideReal &b) { return _mm512_max_ps(a.f, b.f); }
+		static WideReal min(const WideReal &a, const WideReal &b) { return _mm512_min_ps(a.f, b.f); }
+		static WideReal sqrt(const WideReal &x)                     { return _mm512_sqrt_ps(x.f); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	template < int n >
+	class wide_fixed
+	{
+		friend class WideSInt;
+
+	private:
+		__m512i i;
+
+	private:
+		wide_fixed(const __m512i &r) : i(r) {}
+
+	public:
+#ifdef MML_FIXED_H_INCLUDED__
+		typedef mml::fixed<int, n> scalar_t;
+		typedef mml::fixed<int, n> vector_t[TINY_WIDTH];
+#else
+		typedef int scalar_t;
+		typedef int vector_t[TINY_WIDTH];
+#endif
+
+		wide_fixed( void ) {}
+		wide_fixed(const wide_fixed<n> &r) : i(r.i) {}
+		wide_fixed(int val) : i(_mm512_slli_epi32(_mm512_set1_epi32(val), n)) {}
+		wide_fixed(float val) : i(_mm512_cvttps_epi32(_mm512_mul_ps(_mm512_set1_ps(val), _mm512_set1_ps(1 << n)))) {}
+		wide_fixed(bool val) : i(_mm512_slli_epi32(_mm512_set1_epi32(val ? 1 : 0), n)) {}
+		explicit wide_fixed(const int *in) : i(_mm512_slli_epi32(_mm512_loadu_si512(in), n)) {}
+		explicit wide_fixed(const float *in) : i(_mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(in), _mm512_set1_ps(1 << n)))) {}
+		inline explicit wide_fixed(const WideSInt &r);
+		inline explicit wide_fixed(const WideReal &r);
+		inline explicit wide_fixed(const WideBool &r);
+
+		wide_fixed<n> &operator=(const wide_fixed<n>&) = default;
+		wide_fixed<n> &operator=(const cset< wide_fixed<n> > &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		wide_fixed<n> operator-( void ) const { return wide_fixed<n>(0) - *this; }
+
+		wide_fixed<n> &operator+=(const wide_fixed<n> &r) { i = _mm512_add_epi32(i, r.i); return *this; }
+		wide_fixed<n> &operator-=(const wide_fixed<n> &r) { i = _mm512_sub_epi32(i, r.i); return *this; }
+		wide_fixed<n> &operator*=(const wide_fixed<n> &r) { i = _mm512_srai_epi32(_mm512_mullo_epi32(i, r.i), n); return *this; }
+		wide_fixed<n> &operator|=(const wide_fixed<n> &r) { i = _mm512_or_si512(i, r.i); return *this; }
+		wide_fixed<n> &operator|=(const WideBool &r)     { i = _mm512_mask_mov_epi32(i, r.m, _mm512_set1_epi32(int(TINY_TRUE_BITS))); return *this; }
+		wide_fixed<n> &operator&=(const wide_fixed<n> &r) { i = _mm512_and_si512(i, r.i); return *this; }
+		wide_fixed<n> &operator&=(const WideBool &r)     { i = _mm512_maskz_mov_epi32(r.m, i); return *this; }
+
+		wide_fixed<n> operator+(const wide_fixed<n> &r) const { return _mm512_add_epi32(i, r.i); }
+		wide_fixed<n> operator-(const wide_fixed<n> &r) const { return _mm512_sub_epi32(i, r.i); }
+		wide_fixed<n> operator*(const wide_fixed<n> &r) const { wide_fixed<n> o; o.i = i; o *= r; return o; }
+		wide_fixed<n> operator|(const wide_fixed<n> &r) const { return _mm512_or_si512(i, r.i);  }
+		wide_fixed<n> operator|(const WideBool &r)     const { return _mm512_mask_mov_epi32(i, r.m, _mm512_set1_epi32(int(TINY_TRUE_BITS))); }
+		wide_fixed<n> operator&(const wide_fixed<n> &r) const { return _mm512_and_si512(i, r.i); }
+		wide_fixed<n> operator&(const WideBool &r)     const { return _mm512_maskz_mov_epi32(r.m, i); }
+
+		WideBool operator==(const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_EQ);  }
+		WideBool operator!=(const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NE);  }
+		WideBool operator< (const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_LT);  }
+		WideBool operator<=(const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_LE);  }
+		WideBool operator> (const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NLE); }
+		WideBool operator>=(const wide_fixed<n> &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NLT); }
+
+		void to_scalar(int *out) const { _mm512_storeu_si512(out, _mm512_srai_epi32(i, n)); }
+
+		static wide_fixed<n> cmov(const WideBool &cond_mask, const wide_fixed<n> &l, const wide_fixed<n> &r) { return _mm512_mask_blend_epi32(cond_mask.m, r.i, l.i); }
+		static wide_fixed<n> max(const wide_fixed<n> &a, const wide_fixed<n> &b) { return _mm512_max_epi32(a.i, b.i); }
+		static wide_fixed<n> min(const wide_fixed<n> &a, const wide_fixed<n> &b) { return _mm512_min_epi32(a.i, b.i); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	#if TINY_COMPILER == TINY_COMPILER_MSVC
+		__declspec(align(TINY_BYTE_ALIGN))
+	#endif
+	class WideSInt
+	{
+		friend class WideReal;
+		template < int n >
+		friend class wide_fixed;
+
+	private:
+		__m512i i;
+
+	private:
+		WideSInt(const __m512i &r) : i(r) {}
+
+	public:
+		typedef int scalar_t;
+		typedef int vector_t[TINY_WIDTH];
+
+		WideSInt( void ) {}
+		WideSInt(const WideSInt &r) : i(r.i) {}
+		WideSInt(int val) : i(_mm512_set1_epi32(val)) {}
+		WideSInt(bool val) : i(_mm512_set1_epi32(val ? 1 : 0)) {}
+		explicit WideSInt(const int *in) : i(_mm512_loadu_si512(in)) {}
+		explicit WideSInt(const unsigned short *in) : i(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)))) {}
+		template < int n >
+		inline explicit WideSInt(const wide_fixed<n> &f);
+		inline explicit WideSInt(const WideReal &r);
+		inline explicit WideSInt(const WideBool &r);
+
+		WideSInt &operator=(const WideSInt&) = default;
+		WideSInt &operator=(const cset<WideSInt> &test) { *this = cmov(test.test, test.a, *this); return *this; }
+
+		WideSInt operator-( void ) const { return WideSInt(0) - *this; }
+
+		WideSInt &operator+=(const WideSInt &r) { i = _mm512_add_epi32(i, r.i); return *this; }
+		WideSInt &operator-=(const WideSInt &r) { i = _mm512_sub_epi32(i, r.i); return *this; }
+		WideSInt &operator*=(const WideSInt &r) { i = _mm512_mullo_epi32(i, r.i); return *this; }
+		WideSInt &operator|=(const WideSInt &r)  { i = _mm512_or_si512(i, r.i);  return *this; }
+		WideSInt &operator|=(const WideBool &r) { i = _mm512_mask_mov_epi32(i, r.m, _mm512_set1_epi32(int(TINY_TRUE_BITS))); return *this; }
+		WideSInt &operator&=(const WideSInt &r)  { i = _mm512_and_si512(i, r.i); return *this; }
+		WideSInt &operator&=(const WideBool &r) { i = _mm512_maskz_mov_epi32(r.m, i); return *this; }
+		WideSInt &operator<<=(int r) { i = _mm512_slli_epi32(i, r); return *this; }
+		WideSInt &operator>>=(int r) { i = _mm512_srai_epi32(i, r); return *this; }
+
+		WideSInt operator+(const WideSInt &r)  const { return _mm512_add_epi32(i, r.i); }
+		WideSInt operator-(const WideSInt &r)  const { return _mm512_sub_epi32(i, r.i); }
+		WideSInt operator*(const WideSInt &r)  const { return _mm512_mullo_epi32(i, r.i); }
+		WideSInt operator|(const WideSInt &r)  const { return _mm512_or_si512(i, r.i);  }
+		WideSInt operator|(const WideBool &r) const { return _mm512_mask_mov_epi32(i, r.m, _mm512_set1_epi32(int(TINY_TRUE_BITS))); }
+		WideSInt operator&(const WideSInt &r)  const { return _mm512_and_si512(i, r.i); }
+		WideSInt operator&(const WideBool &r) const { return _mm512_maskz_mov_epi32(r.m, i); }
+		WideSInt operator<<(int r) const { return _mm512_slli_epi32(i, r); }
+		WideSInt operator>>(int r) const { return _mm512_srai_epi32(i, r); }
+		WideSInt operator>>(const WideSInt &r) const { return _mm512_srav_epi32(i, r.i); }
+
+		WideBool operator==(const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_EQ);  }
+		WideBool operator!=(const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NE);  }
+		WideBool operator< (const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_LT);  }
+		WideBool operator<=(const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_LE);  }
+		WideBool operator> (const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NLE); }
+		WideBool operator>=(const WideSInt &r) const { return _mm512_cmp_epi32_mask(i, r.i, _MM_CMPINT_NLT); }
+
+		void to_scalar(int *out) const { _mm512_storeu_si512(out, i); }
+
+		static WideSInt cmov(const WideBool &cond_mask, const WideSInt &l, const WideSInt &r) { return _mm512_mask_blend_epi32(cond_mask.m, r.i, l.i); }
+		static WideSInt max(const WideSInt &a, const WideSInt &b) { return _mm512_max_epi32(a.i, b.i); }
+		static WideSInt min(const WideSInt &a, const WideSInt &b) { return _mm512_min_epi32(a.i, b.i); }
+		static WideSInt gather(const void *base, const WideSInt &offsets) { return _mm512_i32gather_epi32(offsets.i, base, 1); }
+	}
+	#if TINY_COMPILER == TINY_COMPILER_GCC
+		__attribute__((aligned(TINY_BYTE_ALIGN)))
+	#endif
+	;
+
+	WideReal::WideReal(const WideSInt &r) : f(_mm512_cvtepi32_ps(r.i)) {}
+	WideReal::WideReal(const WideBool &r) : WideReal(WideReal::cmov(r, WideReal(1.0f), WideReal(0.0f))) {}
+
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideSInt &r) : i(_mm512_slli_epi32(r.i, n)) {}
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideReal &r) : i(_mm512_cvttps_epi32(_mm512_mul_ps(r.f, _mm512_set1_ps(1 << n)))) {}
+	template < int n >
+	wide_fixed<n>::wide_fixed(const WideBool &r) : wide_fixed(wide_fixed<n>::cmov(r, wide_fixed<n>(WideSInt(1)), wide_fixed<n>(WideSInt(0)))) {}
+
+	WideSInt::WideSInt(const WideReal &r)   : i(_mm512_cvttps_epi32(r.f)) {}
+	template < int n >
+	WideSInt::WideSInt(const wide_fixed<n> &r) : i(_mm512_srai_epi32(r.i, n)) {}
+	WideSInt::WideSInt(const WideBool &r) : WideSInt(WideSInt::cmov(r, WideSInt(1), WideSInt(0))) {}
 
 #elif TINY_SIMD == TINY_SIMD_NEON && TINY_COMPILER == TINY_COMPILER_GCC
 
@@ -614,6 +1263,11 @@ namespace tiny3d
 			return (vget_lane_u32(v1, 0) & vget_lane_u32(v1, 1)) == TINY_TRUE_BITS;
 		}
 
+		unsigned int to_bits( void ) const
+		{
+			return (vgetq_lane_u32(u, 0) & 1) | ((vgetq_lane_u32(u, 1) & 1) << 1) | ((vgetq_lane_u32(u, 2) & 1) << 2) | ((vgetq_lane_u32(u, 3) & 1) << 3);
+		}
+
 		operator bool( void ) const { return !all_fail(); }
 
 	} __attribute__((aligned(TINY_BYTE_ALIGN)));
@@ -807,6 +1461,7 @@ namespace tiny3d
 		WideSInt(int val) : i(vdupq_n_s32(val)) {}
 		WideSInt(bool val) : i(vdupq_n_s32(val ? 1 : 0)) {}
 		explicit WideSInt(const int *in) : i(vld1q_s32(in)) {}
+		explicit WideSInt(const unsigned short *in) : i(vreinterpretq_s32_u32(vmovl_u16(vld1_u16(in)))) {}
 		inline explicit WideSInt(const WideReal &r);
 		template < int n >
 		inline explicit WideSInt(const wide_fixed<n> &r);
@@ -841,6 +1496,7 @@ namespace tiny3d
 		WideSInt operator&(const WideBool &r) const { return vandq_s32(i, *(const int32x4_t*)(&r.u)); }
 		WideSInt operator<<(int r) const { return vshlq_n_s32(i, r); }
 		WideSInt operator>>(int r) const { return vshlq_n_s32(i, -r); }
+		WideSInt operator>>(const WideSInt &r) const { return vshlq_s32(i, vnegq_s32(r.i)); }
 //		WideSInt operator/(const WideSInt &r) { WideSInt o = *this; return o /= r; }
 //		WideSInt operator%(const WideSInt &r) { return *this - (*this / r) * r; } // NOTE: May not work for negative numbers. Abs?
 
@@ -863,6 +1519,15 @@ namespace tiny3d
 			rc = vorrq_s32(rc, lc);
 			return rc;
 		}
+		static WideSInt max(const WideSInt &a, const WideSInt &b) { return vmaxq_s32(a.i, b.i); }
+		static WideSInt min(const WideSInt &a, const WideSInt &b) { return vminq_s32(a.i, b.i); }
+		static WideSInt gather(const void *base, const WideSInt &offsets)
+		{
+			int o[TINY_WIDTH], out[TINY_WIDTH];
+			offsets.to_scalar(o);
+			for (int j = 0; j < TINY_WIDTH; ++j) { std::memcpy(out + j, static_cast<const char*>(base) + o[j], sizeof(int)); }
+			return WideSInt(out);
+		}
 
 	} __attribute__((aligned(TINY_BYTE_ALIGN)));
 
@@ -924,6 +1589,8 @@ namespace tiny3d
 		bool all_fail( void ) const;
 		bool all_pass( void ) const;
 
+		unsigned int to_bits( void ) const;
+
 		operator bool( void ) const { return !all_fail(); }
 	};
 
@@ -966,6 +1633,8 @@ namespace tiny3d
 		bool all_fail( void ) const { return u == TINY_FALSE_BITS; }
 		bool all_pass( void ) const { return u == TINY_TRUE_BITS; }
 
+		unsigned int to_bits( void ) const { return u != TINY_FALSE_BITS ? 1 : 0; }
+
 		operator bool( void ) const { return !all_fail(); }
 	};
 
@@ -1015,7 +1684,7 @@ namespace tiny3d
 
 		static WideReal max(const WideReal &a, const WideReal &b) { return a.f < b.f ? b.f : a.f; }
 		static WideReal min(const WideReal &a, const WideReal &b) { return a.f < b.f ? a.f : b.f; }
-		static WideReal sqrt(const WideReal &x)                     { return ::sqrt(x.f); }
+		static WideReal sqrt(const WideReal &x)                     { return std::sqrt(x.f); }
 
 		WideBool operator==(const WideReal &r) const { WideBool o; o.u = (f == r.f) ? TINY_TRUE_BITS : TINY_FALSE_BITS; return o; }
 		WideBool operator!=(const WideReal &r) const { WideBool o; o.u = (f != r.f) ? TINY_TRUE_BITS : TINY_FALSE_BITS; return o; }
@@ -1151,6 +1820,7 @@ namespace tiny3d
 		WideSInt(int val) : i(val) {}
 		WideSInt(bool val) : i(val ? 1 : 0) {}
 		explicit WideSInt(const int *in) : i(*in) {}
+		explicit WideSInt(const unsigned short *in) : i(*in) {}
 		inline explicit WideSInt(const WideReal &f);
 		template < int n >
 		inline explicit WideSInt(const wide_fixed<n> &f);
@@ -1182,6 +1852,7 @@ namespace tiny3d
 		WideSInt operator&(const WideBool &r) const { return int(i & r.u); }
 		WideSInt operator<<(int r) const { return i << r; }
 		WideSInt operator>>(int r) const { return i >> r; }
+		WideSInt operator>>(const WideSInt &r) const { return i >> r.i; }
 //		WideSInt operator/(const WideSInt &r) { WideSInt o = *this; return o /= r; }
 //		WideSInt operator%(const WideSInt &r) { return i % r.i; }
 
@@ -1199,6 +1870,14 @@ namespace tiny3d
 			unsigned int o = (*(unsigned int*)(&r.i) & ~cond_mask.u) | (*(unsigned int*)(&l.i) & cond_mask.u);
 			return WideSInt(*(int*)(&o));
 		}
+		static WideSInt max(const WideSInt &a, const WideSInt &b) { return a.i < b.i ? b.i : a.i; }
+		static WideSInt min(const WideSInt &a, const WideSInt &b) { return a.i < b.i ? a.i : b.i; }
+		static WideSInt gather(const void *base, const WideSInt &offsets)
+		{
+			int out;
+			std::memcpy(&out, static_cast<const char*>(base) + offsets.i, sizeof(int));
+			return WideSInt(out);
+		}
 	};
 
 	WideReal::WideReal(const WideSInt &r) : f((float)r.i) {}
@@ -1242,6 +1921,49 @@ namespace tiny3d
 		cmov(test, l, wide_t(out)).to_scalar(out);
 	}
 
+	// @data WidePoint
+	// @info Contains coordinates for the points covered by the lanes of a SIMD fragment.
+	struct WidePoint
+	{
+		WideSInt x, y;
+	};
+
+	// @data WideColor
+	// @info Contains the colors of the lanes of a SIMD fragment. Each channel is stored in a separate register.
+	struct WideColor
+	{
+		WideSInt r, g, b, blend;
+	};
+
+	inline WideColor operator+(WideColor l, const WideColor &r)
+	{
+		l.r += r.r;
+		l.g += r.g;
+		l.b += r.b;
+		return l;
+	}
+
+	inline WideColor operator-(WideColor l, const WideColor &r)
+	{
+		l.r -= r.r;
+		l.g -= r.g;
+		l.b -= r.b;
+		return l;
+	}
+
+	inline WideColor operator*(WideColor l, const WideReal &r)
+	{
+		return WideColor{
+			WideSInt(WideReal(l.r) * r),
+			WideSInt(WideReal(l.g) * r),
+			WideSInt(WideReal(l.b) * r),
+			l.blend
+		};
+	}
+
 }
+}
+
+TINY_SIMD_TARGET_END
 
 #endif // TINY_SIMD_H
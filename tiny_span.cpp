@@ -0,0 +1,109 @@
+#include <algorithm>
+#include "tiny_span.h"
+
+using namespace tiny3d;
+
+tiny3d::SpanBuffer::SpanBuffer( void ) : m_spans(), m_counts(), m_gaps(), m_width(0), m_height(0), m_capacity(0)
+{}
+
+tiny3d::SpanBuffer::SpanBuffer(tiny3d::UInt width, tiny3d::UInt height) : SpanBuffer()
+{
+	Create(width, height);
+}
+
+void tiny3d::SpanBuffer::Create(tiny3d::UInt width, tiny3d::UInt height)
+{
+	m_width    = width;
+	m_height   = height;
+	m_capacity = (width + 1) / 2;
+	m_spans.Create(m_capacity * height);
+	m_counts.Create(height);
+	m_gaps.Create(m_capacity + 1);
+	Clear();
+}
+
+void tiny3d::SpanBuffer::Destroy( void )
+{
+	m_spans.Destroy();
+	m_counts.Destroy();
+	m_gaps.Destroy();
+	m_width    = 0;
+	m_height   = 0;
+	m_capacity = 0;
+}
+
+void tiny3d::SpanBuffer::Clear( void )
+{
+	for (UInt y = 0; y < m_height; ++y) {
+		m_counts[y] = 0;
+	}
+}
+
+void tiny3d::SpanBuffer::Cover(tiny3d::UInt y, Span span)
+{
+	TINY3D_ASSERT(y < m_height && span.b <= m_width);
+	if (span.a >= span.b) { return; }
+
+	Span *const row   = &m_spans[y * m_capacity];
+	UInt       &count = m_counts[y];
+
+	// the first span ending at or after the new span, and the first span starting after it (touching spans are merged)
+	Span *const first = std::lower_bound(row, row + count, span.a, [](const Span &s, UInt x) { return s.b < x; });
+	Span       *last  = first;
+	while (last != row + count && last->a <= span.b) {
+		span.a = tiny3d::Min(span.a, last->a);
+		span.b = tiny3d::Max(span.b, last->b);
+		++last;
+	}
+	if (first == last) {
+		TINY3D_ASSERT(count < m_capacity);
+		std::copy_backward(first, row + count, row + count + 1);
+		*first = span;
+		++count;
+	} else {
+		*first = span;
+		std::copy(last, row + count, first + 1);
+		count -= UInt(last - first) - 1;
+	}
+}
+
+tiny3d::UInt tiny3d::SpanBuffer::GetUncovered(tiny3d::UInt y, Span span)
+{
+	TINY3D_ASSERT(y < m_height);
+
+	const Span *const row     = &m_spans[y * m_capacity];
+	const Span *const end     = row + m_counts[y];
+	const Span       *covered = std::lower_bound(row, end, span.a, [](const Span &s, UInt x) { return s.b <= x; });
+	UInt              n       = 0;
+	for (; covered != end && covered->a < span.b && span.a < span.b; ++covered) {
+		if (span.a < covered->a) {
+			m_gaps[n++] = Span{ span.a, covered->a };
+		}
+		span.a = covered->b;
+	}
+	if (span.a < span.b) {
+		m_gaps[n++] = span;
+	}
+	return n;
+}
+
+tiny3d::SpanBuffer::Span tiny3d::SpanBuffer::GetGap(tiny3d::UInt i) const
+{
+	return m_gaps[i];
+}
+
+bool tiny3d::SpanBuffer::IsCovered(tiny3d::UInt y) const
+{
+	TINY3D_ASSERT(y < m_height);
+	return m_counts[y] == 1 && m_spans[y * m_capacity].a == 0 && m_spans[y * m_capacity].b >= m_width;
+}
+
+tiny3d::UInt tiny3d::SpanBuffer::GetWidth( void ) const
+{
+	return m_width;
+}
+
+tiny3d::UInt tiny3d::SpanBuffer::GetHeight( void ) const
+{
+	return m_height;
+}
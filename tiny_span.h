@@ -0,0 +1,85 @@
+#ifndef TINY_SPAN_H
+#define TINY_SPAN_H
+
+#include "tiny_system.h"
+#include "tiny_structs.h"
+
+namespace tiny3d
+{
+
+// @data SpanBuffer
+// @info Hidden surface removal without depth values (s-buffer). Keeps a sorted list of non-overlapping covered spans per scanline. Triangles drawn with a span buffer only shade the parts of their scanlines that are still uncovered, and then cover the pixels they shaded opaquely, so triangles submitted front to back shade every pixel exactly once.
+// @note Scanlines are shared between all rectangles that overlap vertically, so a span buffer must not be drawn to by several threads at once.
+// @note Every scanline has room for the most covered spans it can hold, so covering and clearing never allocate. A span buffer takes as much memory as a 32-bit depth buffer of the same dimensions.
+class SpanBuffer
+{
+public:
+	// @data Span
+	// @info A horizontal run of pixels [a, b).
+	struct Span
+	{
+		tiny3d::UInt a, b;
+	};
+
+private:
+	tiny3d::Array<Span>         m_spans;    // m_capacity spans per scanline
+	tiny3d::Array<tiny3d::UInt> m_counts;   // the number of covered spans on each scanline
+	tiny3d::Array<Span>         m_gaps;     // scratch memory for GetUncovered, reused by every triangle
+	tiny3d::UInt                m_width;
+	tiny3d::UInt                m_height;
+	tiny3d::UInt                m_capacity; // spans never touch, so a scanline holds at most (width + 1) / 2 of them
+
+public:
+	SpanBuffer( void );
+	SpanBuffer(tiny3d::UInt width, tiny3d::UInt height);
+
+	// @algo Create
+	// @info Creates an uncovered span buffer with the given dimensions.
+	// @in width, height -> The dimensions in pixels.
+	void Create(tiny3d::UInt width, tiny3d::UInt height);
+
+	// @algo Destroy
+	// @info Frees resources used by the span buffer.
+	void Destroy( void );
+
+	// @algo Clear
+	// @info Uncovers all pixels. Keeps the memory of each scanline so that clearing every frame does not allocate.
+	void Clear( void );
+
+	// @algo Cover
+	// @info Marks a span on a scanline as covered, merging it with the covered spans it overlaps or touches.
+	// @in
+	//   y -> The scanline.
+	//   span -> The span to cover.
+	void Cover(tiny3d::UInt y, Span span);
+
+	// @algo GetUncovered
+	// @info Finds the parts of a span on a scanline that are not yet covered. The parts are stored in scratch memory owned by the span buffer, and stay valid until the next call.
+	// @in
+	//   y -> The scanline.
+	//   span -> The span to test.
+	// @out The number of uncovered parts. See GetGap.
+	tiny3d::UInt GetUncovered(tiny3d::UInt y, Span span);
+
+	// @algo GetGap
+	// @in i -> The index of an uncovered part found by the last call to GetUncovered, from left to right.
+	// @out The uncovered part.
+	Span GetGap(tiny3d::UInt i) const;
+
+	// @algo IsCovered
+	// @in y -> The scanline.
+	// @out TRUE if every pixel of the scanline is covered.
+	bool IsCovered(tiny3d::UInt y) const;
+
+	// @algo GetWidth
+	// @out The width in pixels.
+	tiny3d::UInt GetWidth( void ) const;
+
+	// @algo GetHeight
+	// @out The height in pixels.
+	tiny3d::UInt GetHeight( void ) const;
+};
+
+}
+
+#endif // TINY_SPAN_H
@@ -0,0 +1,68 @@
+#include <cstring>
+#include "tiny_stats.h"
+
+using namespace tiny3d;
+
+#ifdef TINY3D_STATS
+
+// @algo RenderStatsList
+// @out The first counters in the list of counters of all threads.
+std::atomic<internal_impl::ThreadRenderStats*> &RenderStatsList( void )
+{
+	static std::atomic<internal_impl::ThreadRenderStats*> head(nullptr);
+	return head;
+}
+
+internal_impl::ThreadRenderStatsOwner::ThreadRenderStatsOwner( void ) : stats(nullptr)
+{
+	std::atomic<ThreadRenderStats*> &head = RenderStatsList();
+	for (ThreadRenderStats *s = head.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+		bool in_use = false;
+		if (!s->in_use.load(std::memory_order_relaxed) && s->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+			stats = s;
+			return;
+		}
+	}
+	stats = new ThreadRenderStats;
+	for (UInt i = 0; i < ThreadRenderStats::COUNT; ++i) {
+		stats->counters[i].store(0, std::memory_order_relaxed);
+	}
+	stats->in_use.store(true, std::memory_order_relaxed);
+	stats->next = head.load(std::memory_order_relaxed);
+	while (!head.compare_exchange_weak(stats->next, stats, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+internal_impl::ThreadRenderStatsOwner::~ThreadRenderStatsOwner( void )
+{
+	stats->in_use.store(false, std::memory_order_release);
+}
+
+#endif
+
+tiny3d::RenderStats tiny3d::GetRenderStats( void )
+{
+	RenderStats stats;
+	std::memset(&stats, 0, sizeof(stats));
+#ifdef TINY3D_STATS
+	static_assert(sizeof(RenderStats) == sizeof(UXInt) * internal_impl::ThreadRenderStats::COUNT, "RenderStats must only contain counters");
+	UXInt sum[internal_impl::ThreadRenderStats::COUNT] = { 0 };
+	for (const internal_impl::ThreadRenderStats *s = RenderStatsList().load(std::memory_order_acquire); s != nullptr; s = s->next) {
+		for (UInt i = 0; i < internal_impl::ThreadRenderStats::COUNT; ++i) {
+			sum[i] += s->counters[i].load(std::memory_order_relaxed);
+		}
+	}
+	std::memcpy(&stats, sum, sizeof(stats));
+#endif
+	return stats;
+}
+
+void tiny3d::ResetRenderStats( void )
+{
+#ifdef TINY3D_STATS
+	for (internal_impl::ThreadRenderStats *s = RenderStatsList().load(std::memory_order_acquire); s != nullptr; s = s->next) {
+		for (UInt i = 0; i < internal_impl::ThreadRenderStats::COUNT; ++i) {
+			s->counters[i].store(0, std::memory_order_relaxed);
+		}
+	}
+#endif
+}
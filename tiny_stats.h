@@ -0,0 +1,162 @@
+#ifndef TINY_STATS_H
+#define TINY_STATS_H
+
+#include "tiny_system.h"
+
+#ifdef TINY3D_STATS
+	#include <atomic>
+	#include <chrono>
+	#include <cstddef>
+#endif
+
+// @data TINY3D_STATS
+// @info Define when compiling tiny3d to have the Draw functions count their work in tiny3d::RenderStats. When undefined, the default, the counters are compiled out entirely.
+
+namespace tiny3d
+{
+
+// @data RenderStage
+// @info The stages tiny3d::RenderStats measures time for. Stages do not overlap, so the time spent in a stage excludes the time spent in the stages it calls.
+enum RenderStage
+{
+	RenderStage_Setup,  // vertex conversion, culling and triangle setup in the triangle functions
+	RenderStage_Raster, // traversal and shading of triangles
+	RenderStage_Blit,   // DrawRegion and DrawChars
+	RenderStage_Count
+};
+
+// @data RenderStats
+// @info Counts the work done by the triangle functions, and the time spent per stage. Only counted if tiny3d is compiled with TINY3D_STATS defined.
+// @note Every thread counts into counters of its own, which are merged by GetRenderStats without locking. tiny3d::TileRenderer submits a triangle once for every tile it overlaps.
+struct RenderStats
+{
+	tiny3d::UXInt triangles_submitted;         // triangles passed to the triangle functions
+	tiny3d::UXInt triangles_culled;            // triangles discarded before rasterization, i.e. behind the eye, by the cull mode, of zero area, outside of the screen or mask rectangle, or hidden in a HiZBuffer
+	tiny3d::UXInt triangles_rasterized;        // triangles whose bounding box was traversed
+	tiny3d::UXInt bbox_pixels;                 // pixels in the clipped bounding boxes of rasterized triangles
+	tiny3d::UXInt fragments_covered;           // pixels inside of rasterized triangles. DrawTriangle_Fast skips blocks hidden in a HiZBuffer without counting them.
+	tiny3d::UXInt fragments_depth_rejected;    // covered pixels hidden by the depth buffer or span buffer
+	tiny3d::UXInt fragments_stencil_rejected;  // covered pixels passing the depth test whose destination pixel is Color::Transparent
+	tiny3d::UXInt fragments_written;           // pixels written to the destination
+	tiny3d::UXInt texels_fetched;              // texels read for the pixels passing the depth and stencil tests, including the four texels of a bilinear light map sample
+	tiny3d::UXInt stage_ns[RenderStage_Count]; // nanoseconds spent in each stage
+};
+
+// @algo GetRenderStats
+// @out The sum of the counters of all threads. Always zero if tiny3d is compiled without TINY3D_STATS.
+tiny3d::RenderStats GetRenderStats( void );
+
+// @algo ResetRenderStats
+// @info Sets the counters of all threads to zero.
+// @note Must not be called while other threads are drawing.
+void ResetRenderStats( void );
+
+}
+
+#ifdef TINY3D_STATS
+
+namespace internal_impl
+{
+
+// @data ThreadRenderStats
+// @info The counters of one thread, in the order of the members of tiny3d::RenderStats. Only the owning thread writes to them, while any thread may read them.
+// @note Counters are linked in a list that never shrinks. When a thread exits its counters are kept, and taken over by the next new thread, so the list is only as long as the largest number of threads that have drawn at the same time.
+struct ThreadRenderStats
+{
+	static constexpr tiny3d::UInt COUNT = sizeof(tiny3d::RenderStats) / sizeof(tiny3d::UXInt);
+
+	std::atomic<tiny3d::UXInt>  counters[COUNT];
+	std::atomic<bool>           in_use;
+	ThreadRenderStats          *next;
+};
+
+// @data ThreadRenderStatsOwner
+// @info Takes over unused counters, or adds new counters to the list, for the lifetime of a thread.
+struct ThreadRenderStatsOwner
+{
+	ThreadRenderStats *stats;
+
+	 ThreadRenderStatsOwner( void );
+	~ThreadRenderStatsOwner( void );
+};
+
+// @algo LocalRenderStats
+// @out The counters of the calling thread.
+inline ThreadRenderStats &LocalRenderStats( void )
+{
+	static thread_local ThreadRenderStatsOwner owner;
+	return *owner.stats;
+}
+
+// @algo AddRenderStat
+// @info Adds to a counter of the calling thread.
+// @in
+//   counter -> The index of the counter.
+//   n -> The amount to add.
+inline void AddRenderStat(tiny3d::UInt counter, tiny3d::UXInt n)
+{
+	// no other thread writes to the counter, so it does not need an atomic read-modify-write
+	std::atomic<tiny3d::UXInt> &c = LocalRenderStats().counters[counter];
+	c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// @data RenderStageTimer
+// @info Adds the time from construction to destruction to a stage. The stage of the enclosing timer on the same thread is paused meanwhile, so that time is only counted once.
+class RenderStageTimer
+{
+private:
+	typedef std::chrono::steady_clock clock;
+
+	tiny3d::RenderStage  m_stage;
+	clock::time_point    m_start;
+	RenderStageTimer    *m_outer;
+
+private:
+	static RenderStageTimer *&Active( void )
+	{
+		static thread_local RenderStageTimer *active = nullptr;
+		return active;
+	}
+
+	void Stop(clock::time_point now) const
+	{
+		AddRenderStat(tiny3d::UInt(offsetof(tiny3d::RenderStats, stage_ns) / sizeof(tiny3d::UXInt)) + m_stage, tiny3d::UXInt(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count()));
+	}
+
+public:
+	explicit RenderStageTimer(tiny3d::RenderStage stage) : m_stage(stage), m_start(clock::now()), m_outer(Active())
+	{
+		if (m_outer != nullptr) { m_outer->Stop(m_start); }
+		Active() = this;
+	}
+
+	~RenderStageTimer( void )
+	{
+		const clock::time_point now = clock::now();
+		Stop(now);
+		if (m_outer != nullptr) { m_outer->m_start = now; }
+		Active() = m_outer;
+	}
+
+	RenderStageTimer(const RenderStageTimer&) = delete;
+	RenderStageTimer &operator=(const RenderStageTimer&) = delete;
+};
+
+}
+
+// @data TINY3D_STATS_ADD
+// @info Adds to a member of tiny3d::RenderStats for the calling thread. The amount is not evaluated when compiled without TINY3D_STATS.
+#define TINY3D_STATS_ADD(member, n) internal_impl::AddRenderStat(tiny3d::UInt(offsetof(tiny3d::RenderStats, member) / sizeof(tiny3d::UXInt)), tiny3d::UXInt(n))
+
+// @data TINY3D_STATS_TIME
+// @info Adds the time until the end of the enclosing scope to a tiny3d::RenderStage.
+#define TINY3D_STATS_TIME(stage) const internal_impl::RenderStageTimer render_stage_timer(stage)
+
+#else
+
+#define TINY3D_STATS_ADD(member, n)
+#define TINY3D_STATS_TIME(stage)
+
+#endif
+
+#endif // TINY_STATS_H
@@ -170,6 +170,34 @@ enum SampleMode
 	SampleMode_Bilinear,
 };
 
+// @data PerspectiveMode
+// @info Contains all possible values for perspective correction of interpolated vertex attributes.
+enum PerspectiveMode
+{
+	PerspectiveMode_Correct,     // exact perspective divide for every pixel
+	PerspectiveMode_Subdivide8,  // exact perspective divide every 8 pixels, linear interpolation in between
+	PerspectiveMode_Subdivide16, // exact perspective divide every 16 pixels, linear interpolation in between
+	PerspectiveMode_Affine,      // no perspective correction, linear interpolation in screen space
+};
+
+// @data DepthFormat
+// @info Contains all possible values for what depth buffers store.
+// @note 16-bit depth buffers (tiny3d::Array<tiny3d::UHInt>) store the same values in unsigned fixed point and saturate at the ends of the range. Z is stored as 8.8 fixed point (0 to 256, clear to 0xffff), InvZ as 0.16 fixed point (1/z from 0 to 1, i.e. z from 1 to infinity, clear to 0).
+enum DepthFormat
+{
+	DepthFormat_Z,    // depth, where nearer is lower. Clear to infinity.
+	DepthFormat_InvZ, // reciprocal depth, where nearer is higher. Clear to 0. Interpolates linearly in screen space, so depth can be tested before the perspective divide.
+};
+
+// @data CullMode
+// @info Contains all possible values for which triangles to discard by the order of their vertices on screen (with y pointing down). Triangles with zero area are always discarded.
+enum CullMode
+{
+	CullMode_None, // draw both clockwise and counter-clockwise triangles
+	CullMode_CW,   // discard clockwise triangles
+	CullMode_CCW,  // discard counter-clockwise triangles
+};
+
 // @data Array
 // @info A frequently used data structure used to contain an array of data stored linearly in memory.
 template < typename type_t >
@@ -196,6 +224,21 @@ public:
 		m_size = num;
 	}
 
+	// @algo Resize
+	// @info Changes the number of elements in the array, keeping the elements that fit in the new size. Added elements are undefined.
+	// @in num -> The new number of elements.
+	void Resize(UInt num)
+	{
+		if (num == m_size) { return; }
+		type_t *arr = (num > 0) ? new type_t[num] : nullptr;
+		for (UInt i = 0; i < m_size && i < num; ++i) {
+			arr[i] = m_arr[i];
+		}
+		delete [] m_arr;
+		m_arr = arr;
+		m_size = num;
+	}
+
 	// @algo Destroy
 	// @info Frees resources used by array.
 	void Destroy( void )
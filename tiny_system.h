@@ -6,6 +6,7 @@
 #include <limits.h>
 #include <string>
 #include <cstdint>
+#include <cstddef>
 
 #ifdef TINY3D_ASSERT
 	#undef TINY3D_ASSERT
@@ -4,8 +4,6 @@
 using namespace tiny3d;
 
 static constexpr tiny3d::UInt CCC_DIM         =  4;
-static constexpr tiny3d::UInt CCC_DIM_MASK    =  3;
-static constexpr tiny3d::UInt CCC_DIM_SHIFT   =  2;
 static constexpr tiny3d::UInt CCC_COUNT       = 16;
 static constexpr tiny3d::UInt CCC_COUNT_MASK  = 15;
 static constexpr tiny3d::UInt CCC_COUNT_SHIFT =  4;
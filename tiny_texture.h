@@ -13,6 +13,8 @@ namespace tiny3d
 class Texture
 {
 private:
+	friend struct ::internal_impl::SurfaceAccess; // the SIMD texture lookup of tiny_raster_fast.h
+
 	// NOTE: CCC = Color Cell Compression
 	struct CCCBlock
 	{
@@ -26,6 +28,10 @@ private:
 		tiny3d::UInt bit;
 	};
 
+	// NOTE: Members since the SIMD texture lookup in tiny_raster_fast.h decodes the blocks as well.
+	static constexpr tiny3d::UInt CCC_DIM_MASK  = 3;
+	static constexpr tiny3d::UInt CCC_DIM_SHIFT = 2;
+
 private:
 	CCCBlock                 *m_texels; // compressed
 	tiny3d::UInt              m_dimension;
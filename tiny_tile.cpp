@@ -0,0 +1,383 @@
+#include "tiny_tile.h"
+#include "tiny_draw.h"
+#include "tiny_raster.h"
+
+using namespace tiny3d;
+
+tiny3d::Rect Bounds(const tiny3d::Vector3 &a, const tiny3d::Vector3 &b)
+{
+	return tiny3d::Rect{
+		{ tiny3d::Min(SInt(a.x), SInt(b.x)),     tiny3d::Min(SInt(a.y), SInt(b.y))     },
+		{ tiny3d::Max(SInt(a.x), SInt(b.x)) + 1, tiny3d::Max(SInt(a.y), SInt(b.y)) + 1 }
+	};
+}
+
+tiny3d::Rect Bounds(const tiny3d::Vector3 &a, const tiny3d::Vector3 &b, const tiny3d::Vector3 &c)
+{
+	return tiny3d::Rect{
+		{ tiny3d::Min(SInt(a.x), SInt(b.x), SInt(c.x)),     tiny3d::Min(SInt(a.y), SInt(b.y), SInt(c.y))     },
+		{ tiny3d::Max(SInt(a.x), SInt(b.x), SInt(c.x)) + 1, tiny3d::Max(SInt(a.y), SInt(b.y), SInt(c.y)) + 1 }
+	};
+}
+
+bool IsEmpty(const tiny3d::URect &r)
+{
+	return r.a.x >= r.b.x || r.a.y >= r.b.y;
+}
+
+void tiny3d::TileRenderer::BindDepthBuffers(Command &cmd, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite)
+{
+	cmd.zread    = zread;
+	cmd.zwrite   = zwrite;
+	cmd.zread16  = nullptr;
+	cmd.zwrite16 = nullptr;
+}
+
+void tiny3d::TileRenderer::BindDepthBuffers(Command &cmd, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite)
+{
+	cmd.zread    = nullptr;
+	cmd.zwrite   = nullptr;
+	cmd.zread16  = zread;
+	cmd.zwrite16 = zwrite;
+}
+
+template < typename depth_t >
+bool tiny3d::TileRenderer::Record(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, tiny3d::Rect bounds, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, Command &cmd) const
+{
+	const URect srect = URect{ { 0, 0 }, { dst.GetWidth(), dst.GetHeight() } };
+	cmd.type         = type;
+	cmd.dst          = &dst;
+	BindDepthBuffers(cmd, zread, zwrite);
+	cmd.tex          = tex;
+	cmd.lightmap     = lightmap;
+	cmd.perspective  = PerspectiveMode_Correct;
+	cmd.depth_format = depth_format;
+	cmd.hiz          = nullptr;
+	cmd.rect         = (dst_rect != nullptr) ? tiny3d::Clip(*dst_rect, srect) : srect;
+	if (IsEmpty(cmd.rect) || bounds.b.x <= 0 || bounds.b.y <= 0) { return false; }
+	bounds.a.x = tiny3d::Max(bounds.a.x, SInt(0));
+	bounds.a.y = tiny3d::Max(bounds.a.y, SInt(0));
+	cmd.bounds = tiny3d::Clip(cmd.rect, URect{ { UInt(bounds.a.x), UInt(bounds.a.y) }, { UInt(bounds.b.x), UInt(bounds.b.y) } });
+	return !IsEmpty(cmd.bounds);
+}
+
+void tiny3d::TileRenderer::Bin( void )
+{
+	UInt width  = 0;
+	UInt height = 0;
+	for (size_t i = 0; i < m_commands.size(); ++i) {
+		width  = tiny3d::Max(width,  m_commands[i].rect.b.x);
+		height = tiny3d::Max(height, m_commands[i].rect.b.y);
+	}
+	m_tiles_x = (width  + m_tile_size - 1) / m_tile_size;
+	m_tiles_y = (height + m_tile_size - 1) / m_tile_size;
+
+	// NOTE: Keep the old bins around to avoid reallocating every frame.
+	if (m_bins.size() < m_tiles_x * m_tiles_y) {
+		m_bins.resize(m_tiles_x * m_tiles_y);
+	}
+	for (size_t i = 0; i < m_bins.size(); ++i) {
+		m_bins[i].clear();
+	}
+
+	for (size_t i = 0; i < m_commands.size(); ++i) {
+		const URect &b = m_commands[i].bounds;
+		const UInt  x0 = b.a.x / m_tile_size;
+		const UInt  x1 = (b.b.x - 1) / m_tile_size;
+		const UInt  y0 = b.a.y / m_tile_size;
+		const UInt  y1 = (b.b.y - 1) / m_tile_size;
+		for (UInt y = y0; y <= y1; ++y) {
+			for (UInt x = x0; x <= x1; ++x) {
+				m_bins[x + y * m_tiles_x].push_back(UInt(i));
+			}
+		}
+	}
+}
+
+template < typename depth_t >
+void tiny3d::TileRenderer::RenderCommand(const Command &cmd, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::URect &rect) const
+{
+	switch (cmd.type)
+	{
+	case Command_Line:
+		tiny3d::DrawLine(*cmd.dst, zread, zwrite, m_verts[cmd.vert], m_verts[cmd.vert + 1], cmd.tex, &rect, cmd.depth_format);
+		break;
+	case Command_Triangle:
+		tiny3d::DrawTriangle(*cmd.dst, zread, zwrite, m_verts[cmd.vert], m_verts[cmd.vert + 1], m_verts[cmd.vert + 2], cmd.tex, &rect, cmd.depth_format, CullMode_None);
+		break;
+	case Command_Triangle_Fast:
+		tiny3d::DrawTriangle_Fast(*cmd.dst, zread, zwrite, m_verts[cmd.vert], m_verts[cmd.vert + 1], m_verts[cmd.vert + 2], cmd.tex, &rect, cmd.perspective, cmd.depth_format, cmd.hiz, CullMode_None);
+		break;
+	case Command_LTriangle:
+		tiny3d::DrawTriangle(*cmd.dst, zread, zwrite, m_lverts[cmd.vert], m_lverts[cmd.vert + 1], m_lverts[cmd.vert + 2], cmd.tex, *cmd.lightmap, &rect, cmd.depth_format, CullMode_None);
+		break;
+	case Command_LTriangle_Fast:
+		tiny3d::DrawTriangle_Fast(*cmd.dst, zread, zwrite, m_lverts[cmd.vert], m_lverts[cmd.vert + 1], m_lverts[cmd.vert + 2], cmd.tex, *cmd.lightmap, &rect, cmd.perspective, cmd.depth_format, cmd.hiz, CullMode_None);
+		break;
+	}
+}
+
+void tiny3d::TileRenderer::RenderTile(tiny3d::UInt tile)
+{
+	const std::vector<UInt> &bin = m_bins[tile];
+	if (bin.empty()) { return; }
+
+	const UInt  x = (tile % m_tiles_x) * m_tile_size;
+	const UInt  y = (tile / m_tiles_x) * m_tile_size;
+	const URect tile_rect = URect{ { x, y }, { x + m_tile_size, y + m_tile_size } };
+
+	for (size_t i = 0; i < bin.size(); ++i) {
+		const Command &cmd  = m_commands[bin[i]];
+		const URect    rect = tiny3d::Clip(cmd.rect, tile_rect);
+		if (cmd.zread16 != nullptr || cmd.zwrite16 != nullptr) {
+			RenderCommand(cmd, cmd.zread16, cmd.zwrite16, rect);
+		} else {
+			RenderCommand(cmd, cmd.zread, cmd.zwrite, rect);
+		}
+	}
+}
+
+void tiny3d::TileRenderer::RenderTiles( void )
+{
+	const UInt tile_count = m_tiles_x * m_tiles_y;
+	for (UInt tile = m_next_tile++; tile < tile_count; tile = m_next_tile++) {
+		RenderTile(tile);
+	}
+}
+
+void tiny3d::TileRenderer::Work(tiny3d::UInt generation)
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_start.wait(lock, [&]{ return m_quit || m_generation != generation; });
+			if (m_quit) { return; }
+			generation = m_generation;
+		}
+
+		RenderTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_active == 0) { m_done.notify_all(); }
+		}
+	}
+}
+
+void tiny3d::TileRenderer::StopWorkers( void )
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_start.notify_all();
+	for (size_t i = 0; i < m_workers.size(); ++i) {
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_quit = false;
+}
+
+tiny3d::TileRenderer::TileRenderer( void ) : TileRenderer(0)
+{}
+
+tiny3d::TileRenderer::TileRenderer(tiny3d::UInt thread_count, tiny3d::UInt tile_size) : m_tile_size(0), m_tiles_x(0), m_tiles_y(0), m_next_tile(0), m_generation(0), m_active(0), m_quit(false)
+{
+	SetTileSize(tile_size);
+	SetThreadCount(thread_count);
+}
+
+tiny3d::TileRenderer::~TileRenderer( void )
+{
+	StopWorkers();
+}
+
+void tiny3d::TileRenderer::SetThreadCount(tiny3d::UInt thread_count)
+{
+	if (thread_count == 0) {
+		thread_count = tiny3d::Max(UInt(std::thread::hardware_concurrency()), UInt(1));
+	}
+	if (thread_count == GetThreadCount()) { return; }
+	StopWorkers();
+	// NOTE: The calling thread renders tiles as well, so it counts as one of the threads.
+	for (UInt i = 1; i < thread_count; ++i) {
+		m_workers.push_back(std::thread(&TileRenderer::Work, this, m_generation));
+	}
+}
+
+tiny3d::UInt tiny3d::TileRenderer::GetThreadCount( void ) const
+{
+	return UInt(m_workers.size()) + 1;
+}
+
+void tiny3d::TileRenderer::SetTileSize(tiny3d::UInt tile_size)
+{
+	// NOTE: Keep tiles aligned to the widest SIMD fragment.
+	m_tile_size = tiny3d::Max((tile_size + 15) & ~UInt(15), UInt(16));
+}
+
+tiny3d::UInt tiny3d::TileRenderer::GetTileSize( void ) const
+{
+	return m_tile_size;
+}
+
+template < typename depth_t >
+void tiny3d::TileRenderer::RecordLine(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	Command cmd;
+	if (Record(Command_Line, dst, zread, zwrite, Bounds(a.v, b.v), tex, nullptr, dst_rect, depth_format, cmd)) {
+		cmd.vert = UInt(m_verts.size());
+		m_verts.push_back(a);
+		m_verts.push_back(b);
+		m_commands.push_back(cmd);
+	}
+}
+
+template < typename depth_t >
+void tiny3d::TileRenderer::RecordTriangle(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	// triangles are culled before they are recorded and stored clockwise, so they are drawn without culling
+	const SXInt area_x2 = DetermineHalfspace(ScreenPoint(b), ScreenPoint(c), ScreenPoint(a));
+	if (IsCulled(area_x2, cull_mode)) { return; }
+	const bool flip = area_x2 < 0;
+	Command cmd;
+	if (Record(type, dst, zread, zwrite, Bounds(a.v, b.v, c.v), tex, nullptr, dst_rect, depth_format, cmd)) {
+		cmd.perspective = perspective;
+		cmd.hiz         = hiz;
+		cmd.vert = UInt(m_verts.size());
+		m_verts.push_back(a);
+		m_verts.push_back(flip ? c : b);
+		m_verts.push_back(flip ? b : c);
+		m_commands.push_back(cmd);
+	}
+}
+
+template < typename depth_t >
+void tiny3d::TileRenderer::RecordTriangle(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	// triangles are culled before they are recorded and stored clockwise, so they are drawn without culling
+	const SXInt area_x2 = DetermineHalfspace(ScreenPoint(b), ScreenPoint(c), ScreenPoint(a));
+	if (IsCulled(area_x2, cull_mode)) { return; }
+	const bool flip = area_x2 < 0;
+	Command cmd;
+	if (Record(type, dst, zread, zwrite, Bounds(a.v, b.v, c.v), tex, &lightmap, dst_rect, depth_format, cmd)) {
+		cmd.perspective = perspective;
+		cmd.hiz         = hiz;
+		cmd.vert = UInt(m_lverts.size());
+		m_lverts.push_back(a);
+		m_lverts.push_back(flip ? c : b);
+		m_lverts.push_back(flip ? b : c);
+		m_commands.push_back(cmd);
+	}
+}
+
+void tiny3d::TileRenderer::DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	RecordLine(dst, zread, zwrite, a, b, tex, dst_rect, depth_format);
+}
+
+void tiny3d::TileRenderer::DrawLine(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	RecordLine(dst, zread, zwrite, a, b, tex, dst_rect, depth_format);
+}
+
+void tiny3d::TileRenderer::DrawLine(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format)
+{
+	RecordLine<float>(dst, nullptr, nullptr, a, b, tex, dst_rect, depth_format);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_Triangle, dst, zread, zwrite, a, b, c, tex, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_Triangle, dst, zread, zwrite, a, b, c, tex, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle<float>(Command_Triangle, dst, nullptr, nullptr, a, b, c, tex, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_Triangle_Fast, dst, zread, zwrite, a, b, c, tex, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_Triangle_Fast, dst, zread, zwrite, a, b, c, tex, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle<float>(Command_Triangle_Fast, dst, nullptr, nullptr, a, b, c, tex, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_LTriangle, dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_LTriangle, dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle<float>(Command_LTriangle, dst, nullptr, nullptr, a, b, c, tex, lightmap, dst_rect, PerspectiveMode_Correct, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_LTriangle_Fast, dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle(Command_LTriangle_Fast, dst, zread, zwrite, a, b, c, tex, lightmap, dst_rect, perspective, depth_format, hiz, cull_mode);
+}
+
+void tiny3d::TileRenderer::DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::CullMode cull_mode)
+{
+	RecordTriangle<float>(Command_LTriangle_Fast, dst, nullptr, nullptr, a, b, c, tex, lightmap, dst_rect, perspective, depth_format, nullptr, cull_mode);
+}
+
+void tiny3d::TileRenderer::Flush( void )
+{
+	if (m_commands.empty()) { return; }
+
+	Bin();
+
+	m_next_tile = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_active = UInt(m_workers.size());
+		++m_generation;
+	}
+	m_start.notify_all();
+
+	RenderTiles();
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [&]{ return m_active == 0; });
+	}
+
+	Clear();
+}
+
+void tiny3d::TileRenderer::Clear( void )
+{
+	m_commands.clear();
+	m_verts.clear();
+	m_lverts.clear();
+}
+
+tiny3d::UInt tiny3d::TileRenderer::GetCommandCount( void ) const
+{
+	return UInt(m_commands.size());
+}
@@ -0,0 +1,159 @@
+#ifndef TINY_TILE_H
+#define TINY_TILE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tiny_system.h"
+#include "tiny_math.h"
+#include "tiny_image.h"
+#include "tiny_texture.h"
+#include "tiny_structs.h"
+#include "tiny_hiz.h"
+
+namespace tiny3d
+{
+
+// @data TileRenderer
+// @info Records draw calls and rasterizes them in parallel by dividing the destination into screen tiles. Each tile is rendered by exactly one thread using the dst_rect of the regular draw functions, and draw calls are rendered in submission order within each tile, so the final frame does not depend on the number of threads.
+// @note Images, depth buffers and textures passed to the recording functions are referenced, not copied, and must stay valid until Flush returns.
+class TileRenderer
+{
+private:
+	enum CommandType
+	{
+		Command_Line,
+		Command_Triangle,
+		Command_Triangle_Fast,
+		Command_LTriangle,
+		Command_LTriangle_Fast
+	};
+
+	struct Command
+	{
+		CommandType                         type;
+		tiny3d::Image                      *dst;
+		const tiny3d::Array<float>         *zread;
+		tiny3d::Array<float>               *zwrite;
+		const tiny3d::Array<tiny3d::UHInt> *zread16;
+		tiny3d::Array<tiny3d::UHInt>       *zwrite16;
+		const tiny3d::Texture              *tex;
+		const tiny3d::Texture              *lightmap;
+		tiny3d::URect                       rect;   // the mask rectangle clipped against the destination
+		tiny3d::URect                       bounds; // the bounding box of the primitive clipped against the mask rectangle
+		tiny3d::PerspectiveMode             perspective;
+		tiny3d::DepthFormat                 depth_format;
+		tiny3d::HiZBuffer                  *hiz;
+		tiny3d::UInt                        vert;   // the index of the first vertex
+	};
+
+private:
+	std::vector<Command>                    m_commands;
+	std::vector<tiny3d::Vertex>             m_verts;
+	std::vector<tiny3d::LVertex>            m_lverts;
+	std::vector< std::vector<tiny3d::UInt> > m_bins;
+	tiny3d::UInt                            m_tile_size;
+	tiny3d::UInt                            m_tiles_x;
+	tiny3d::UInt                            m_tiles_y;
+	std::vector<std::thread>                m_workers;
+	std::mutex                              m_mutex;
+	std::condition_variable                 m_start;
+	std::condition_variable                 m_done;
+	std::atomic<tiny3d::UInt>               m_next_tile;
+	tiny3d::UInt                            m_generation;
+	tiny3d::UInt                            m_active;
+	bool                                    m_quit;
+
+private:
+	static void BindDepthBuffers(Command &cmd, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite);
+	static void BindDepthBuffers(Command &cmd, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite);
+	template < typename depth_t >
+	bool Record(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, tiny3d::Rect bounds, const tiny3d::Texture *tex, const tiny3d::Texture *lightmap, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format, Command &cmd) const;
+	template < typename depth_t >
+	void RecordLine(tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::DepthFormat depth_format);
+	template < typename depth_t >
+	void RecordTriangle(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode);
+	template < typename depth_t >
+	void RecordTriangle(CommandType type, tiny3d::Image &dst, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect, tiny3d::PerspectiveMode perspective, tiny3d::DepthFormat depth_format, tiny3d::HiZBuffer *hiz, tiny3d::CullMode cull_mode);
+	template < typename depth_t >
+	void RenderCommand(const Command &cmd, const tiny3d::Array<depth_t> *zread, tiny3d::Array<depth_t> *zwrite, const tiny3d::URect &rect) const;
+	void Bin( void );
+	void RenderTile(tiny3d::UInt tile);
+	void RenderTiles( void );
+	void Work(tiny3d::UInt generation);
+	void StopWorkers( void );
+
+public:
+	 TileRenderer( void );
+	 explicit TileRenderer(tiny3d::UInt thread_count, tiny3d::UInt tile_size = DefaultTileSize());
+	 TileRenderer(const tiny3d::TileRenderer&) = delete;
+	~TileRenderer( void );
+
+	tiny3d::TileRenderer &operator=(const tiny3d::TileRenderer&) = delete;
+
+	// @algo SetThreadCount
+	// @info Sets the number of threads used to render tiles. The calling thread counts as one of the threads.
+	// @note Must not be called during Flush.
+	// @in thread_count -> The number of threads. 0 to use one thread per hardware thread.
+	void SetThreadCount(tiny3d::UInt thread_count);
+
+	// @algo GetThreadCount
+	// @out The number of threads used to render tiles.
+	tiny3d::UInt GetThreadCount( void ) const;
+
+	// @algo SetTileSize
+	// @info Sets the width and height in pixels of a screen tile. Rounded up to a multiple of 16 pixels.
+	// @in tile_size -> The tile dimension.
+	void SetTileSize(tiny3d::UInt tile_size);
+
+	// @algo GetTileSize
+	// @out The width and height in pixels of a screen tile.
+	tiny3d::UInt GetTileSize( void ) const;
+
+	// @algo DrawLine
+	// @info Records a line. See tiny3d::DrawLine.
+	void DrawLine(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+	void DrawLine(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+	void DrawLine(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z);
+
+	// @algo DrawTriangle
+	// @info Records a triangle. See tiny3d::DrawTriangle.
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, const tiny3d::Texture *tex, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+
+	// @algo DrawTriangle
+	// @info Records a lightmap shaded triangle. See tiny3d::DrawTriangle.
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<float> *zread, tiny3d::Array<float> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, const tiny3d::Array<tiny3d::UHInt> *zread, tiny3d::Array<tiny3d::UHInt> *zwrite, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::HiZBuffer *hiz = nullptr, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+	void DrawTriangle_Fast(tiny3d::Image &dst, std::nullptr_t, std::nullptr_t, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, const tiny3d::Texture *tex, const tiny3d::Texture &lightmap, const tiny3d::URect *dst_rect = nullptr, tiny3d::PerspectiveMode perspective = tiny3d::PerspectiveMode_Correct, tiny3d::DepthFormat depth_format = tiny3d::DepthFormat_Z, tiny3d::CullMode cull_mode = tiny3d::CullMode_CCW);
+
+	// @algo Flush
+	// @info Sorts all recorded draw calls into tiles, renders the tiles in parallel and clears the recorded draw calls. Returns when all tiles are rendered.
+	void Flush( void );
+
+	// @algo Clear
+	// @info Discards all recorded draw calls without rendering them.
+	void Clear( void );
+
+	// @algo GetCommandCount
+	// @out The number of recorded draw calls waiting to be flushed.
+	tiny3d::UInt GetCommandCount( void ) const;
+
+	// @algo DefaultTileSize
+	// @out The default width and height in pixels of a screen tile.
+	static constexpr tiny3d::UInt DefaultTileSize( void ) { return 64; }
+};
+
+}
+
+#endif // TINY_TILE_H
@@ -0,0 +1,259 @@
+#include "tiny_transform.h"
+#include "tiny_simd.h"
+
+using namespace tiny3d;
+
+// @algo Position
+// @in v -> A vertex.
+// @out The position of the vertex.
+tiny3d::Vector3 &Position(tiny3d::Vector3 &v)             { return v; }
+const tiny3d::Vector3 &Position(const tiny3d::Vector3 &v) { return v; }
+tiny3d::Vector3 &Position(tiny3d::Vertex &v)              { return v.v; }
+const tiny3d::Vector3 &Position(const tiny3d::Vertex &v)  { return v.v; }
+tiny3d::Vector3 &Position(tiny3d::LVertex &v)             { return v.v; }
+const tiny3d::Vector3 &Position(const tiny3d::LVertex &v) { return v.v; }
+
+// @data WideTransform
+// @info The rows of a transform matrix and a viewport mapping, each element broadcast to all lanes.
+struct WideTransform
+{
+	WideReal m[4][4];
+	WideReal half_w, half_h; // half the size of the viewport
+	WideReal mid_x, mid_y;   // the center of the viewport
+};
+
+// @algo ProjectBatch
+// @info Transforms and projects TINY_WIDTH positions stored in SoA layout.
+// @in t -> The transform.
+// @inout x, y, z -> The model space coordinates. Overwritten by the screen space coordinates.
+void ProjectBatch(const WideTransform &t, float *x, float *y, float *z)
+{
+	const WideReal mx = WideReal(x);
+	const WideReal my = WideReal(y);
+	const WideReal mz = WideReal(z);
+
+	const WideReal cx = t.m[0][0] * mx + t.m[0][1] * my + t.m[0][2] * mz + t.m[0][3];
+	const WideReal cy = t.m[1][0] * mx + t.m[1][1] * my + t.m[1][2] * mz + t.m[1][3];
+	const WideReal cw = t.m[3][0] * mx + t.m[3][1] * my + t.m[3][2] * mz + t.m[3][3];
+
+	const WideReal inv_w = WideReal(1.0f) / cw;
+	(t.mid_x + cx * inv_w * t.half_w).to_scalar(x);
+	(t.mid_y - cy * inv_w * t.half_h).to_scalar(y);
+	cw.to_scalar(z);
+}
+
+// @algo Project
+// @info Transforms and projects an array of vertices, TINY_WIDTH at a time. The last batch is padded with copies of its first vertex.
+template < typename vert_t >
+void Project(const tiny3d::Matrix4x4 &transform, const vert_t *in, tiny3d::UInt count, tiny3d::URect viewport, vert_t *out)
+{
+	WideTransform t;
+	for (UInt row = 0; row < 4; ++row) {
+		for (UInt col = 0; col < 4; ++col) {
+			t.m[row][col] = WideReal(transform[row][col]);
+		}
+	}
+	t.half_w = WideReal(float(viewport.b.x - viewport.a.x) * 0.5f);
+	t.half_h = WideReal(float(viewport.b.y - viewport.a.y) * 0.5f);
+	t.mid_x  = WideReal(float(viewport.a.x + viewport.b.x) * 0.5f);
+	t.mid_y  = WideReal(float(viewport.a.y + viewport.b.y) * 0.5f);
+
+	WideReal::vector_t x, y, z;
+	for (UInt i = 0; i < count; i += TINY_WIDTH) {
+		const UInt n = tiny3d::Min(UInt(TINY_WIDTH), count - i);
+		for (UInt j = 0; j < TINY_WIDTH; ++j) {
+			const Vector3 &p = Position(in[i + (j < n ? j : 0)]);
+			x[j] = p.x;
+			y[j] = p.y;
+			z[j] = p.z;
+		}
+		ProjectBatch(t, x, y, z);
+		for (UInt j = 0; j < n; ++j) {
+			out[i + j] = in[i + j];
+			Position(out[i + j]) = Vector3(x[j], y[j], z[j]);
+		}
+	}
+}
+
+// @algo GuardBand
+// @out The largest distance in pixels from the origin of the destination a clipped vertex can be projected to. Keeps the doubled area of any triangle within the 32-bit range used by the rasterizer.
+constexpr float GuardBand( void ) { return 8192.0f; }
+
+// @algo Lerp
+// @info Linearly interpolates the attributes of two vertices. The position is left undefined.
+// @in
+//   a, b -> The vertices.
+//   t -> The interpolation factor from a (0) to b (1).
+// @out The interpolated vertex.
+tiny3d::Vertex Lerp(const tiny3d::Vertex &a, const tiny3d::Vertex &b, float t)
+{
+	tiny3d::Vertex v;
+	v.t       = a.t + (b.t - a.t) * t;
+	v.c.r     = Byte(float(a.c.r) + (float(b.c.r) - float(a.c.r)) * t + 0.5f);
+	v.c.g     = Byte(float(a.c.g) + (float(b.c.g) - float(a.c.g)) * t + 0.5f);
+	v.c.b     = Byte(float(a.c.b) + (float(b.c.b) - float(a.c.b)) * t + 0.5f);
+	v.c.blend = a.c.blend;
+	return v;
+}
+
+tiny3d::LVertex Lerp(const tiny3d::LVertex &a, const tiny3d::LVertex &b, float t)
+{
+	tiny3d::LVertex v;
+	v.t = a.t + (b.t - a.t) * t;
+	v.l = a.l + (b.l - a.l) * t;
+	return v;
+}
+
+// @data ClipVertex
+// @info A vertex in homogeneous clip space.
+template < typename vert_t >
+struct ClipVertex
+{
+	float  x, y, z, w;
+	vert_t attr;
+};
+
+// @data ClipPlane
+// @info A plane in homogeneous clip space. Points where the dot product with the plane is negative are outside.
+struct ClipPlane
+{
+	float x, y, z, w;
+
+	template < typename vert_t >
+	float Distance(const ClipVertex<vert_t> &v) const { return x * v.x + y * v.y + z * v.z + w * v.w; }
+};
+
+// @algo ClipPolygon
+// @info Clips a convex polygon against a plane (Sutherland-Hodgman).
+// @in
+//   in -> The vertices of the polygon.
+//   count -> The number of vertices.
+//   plane -> The plane to clip against.
+// @out
+//   out -> The vertices of the clipped polygon. Must hold count + 1 vertices.
+//   RETURN -> The number of vertices of the clipped polygon.
+template < typename vert_t >
+tiny3d::UInt ClipPolygon(const ClipVertex<vert_t> *in, tiny3d::UInt count, const ClipPlane &plane, ClipVertex<vert_t> *out)
+{
+	UInt n = 0;
+	for (UInt i = 0, j = count - 1; i < count; j = i++) {
+		const ClipVertex<vert_t> &a = in[j];
+		const ClipVertex<vert_t> &b = in[i];
+		const float da = plane.Distance(a);
+		const float db = plane.Distance(b);
+		if ((da >= 0.0f) != (db >= 0.0f)) {
+			// always interpolate from the inside vertex so that shared edges are clipped identically
+			const ClipVertex<vert_t> &p  = (da >= 0.0f) ? a : b;
+			const ClipVertex<vert_t> &q  = (da >= 0.0f) ? b : a;
+			const float               dp = (da >= 0.0f) ? da : db;
+			const float               dq = (da >= 0.0f) ? db : da;
+			const float               t  = dp / (dp - dq);
+			ClipVertex<vert_t> &v = out[n++];
+			v.x    = p.x + (q.x - p.x) * t;
+			v.y    = p.y + (q.y - p.y) * t;
+			v.z    = p.z + (q.z - p.z) * t;
+			v.w    = p.w + (q.w - p.w) * t;
+			v.attr = Lerp(p.attr, q.attr, t);
+		}
+		if (db >= 0.0f) {
+			out[n++] = b;
+		}
+	}
+	return n;
+}
+
+// @algo ProjectClipped
+// @info Transforms, clips and projects a triangle. See tiny3d::ProjectTriangle.
+template < typename vert_t >
+tiny3d::UInt ProjectClipped(const tiny3d::Matrix4x4 &transform, const vert_t &a, const vert_t &b, const vert_t &c, tiny3d::URect viewport, vert_t *out, bool clip_far)
+{
+	static constexpr UInt MAX_PLANES = 6;
+	static constexpr UInt MAX_VERTS  = 3 + MAX_PLANES;
+
+	if (viewport.b.x <= viewport.a.x || viewport.b.y <= viewport.a.y) { return 0; } // the guard band planes divide by the viewport size
+
+	const float half_w = float(viewport.b.x - viewport.a.x) * 0.5f;
+	const float half_h = float(viewport.b.y - viewport.a.y) * 0.5f;
+	const float mid_x  = float(viewport.a.x + viewport.b.x) * 0.5f;
+	const float mid_y  = float(viewport.a.y + viewport.b.y) * 0.5f;
+
+	// screen x = mid_x + x/w * half_w and screen y = mid_y - y/w * half_h must be inside [-GuardBand, GuardBand]
+	const ClipPlane planes[MAX_PLANES] = {
+		{  0.0f,  0.0f,  1.0f, 1.0f },                          // near
+		{  1.0f,  0.0f,  0.0f, (GuardBand() + mid_x) / half_w }, // left guard band
+		{ -1.0f,  0.0f,  0.0f, (GuardBand() - mid_x) / half_w }, // right guard band
+		{  0.0f, -1.0f,  0.0f, (GuardBand() + mid_y) / half_h }, // top guard band
+		{  0.0f,  1.0f,  0.0f, (GuardBand() - mid_y) / half_h }, // bottom guard band
+		{  0.0f,  0.0f, -1.0f, 1.0f }                           // far
+	};
+	const UInt num_planes = clip_far ? MAX_PLANES : MAX_PLANES - 1;
+
+	ClipVertex<vert_t> poly[2][MAX_VERTS];
+	const vert_t *src[3] = { &a, &b, &c };
+	for (UInt i = 0; i < 3; ++i) {
+		const Vector3 &p = src[i]->v;
+		ClipVertex<vert_t> &v = poly[0][i];
+		v.x    = transform[0][0] * p.x + transform[0][1] * p.y + transform[0][2] * p.z + transform[0][3];
+		v.y    = transform[1][0] * p.x + transform[1][1] * p.y + transform[1][2] * p.z + transform[1][3];
+		v.z    = transform[2][0] * p.x + transform[2][1] * p.y + transform[2][2] * p.z + transform[2][3];
+		v.w    = transform[3][0] * p.x + transform[3][1] * p.y + transform[3][2] * p.z + transform[3][3];
+		v.attr = *src[i];
+	}
+
+	UInt count = 3;
+	UInt cur   = 0;
+	for (UInt i = 0; i < num_planes; ++i) {
+		UInt outside = 0;
+		for (UInt j = 0; j < count; ++j) {
+			outside += planes[i].Distance(poly[cur][j]) < 0.0f ? 1 : 0;
+		}
+		if (outside == count) { return 0; }
+		if (outside == 0)     { continue; }
+		count = ClipPolygon(poly[cur], count, planes[i], poly[1 - cur]);
+		cur   = 1 - cur;
+		if (count < 3) { return 0; }
+	}
+
+	vert_t proj[MAX_VERTS];
+	for (UInt i = 0; i < count; ++i) {
+		const ClipVertex<vert_t> &v = poly[cur][i];
+		const float inv_w = 1.0f / v.w;
+		proj[i]   = v.attr;
+		proj[i].v = Vector3( // clamped, since a vertex on a guard band plane may project a rounding error past it
+			Clamp(-GuardBand(), mid_x + v.x * inv_w * half_w, GuardBand()),
+			Clamp(-GuardBand(), mid_y - v.y * inv_w * half_h, GuardBand()),
+			v.w
+		);
+	}
+	for (UInt i = 2; i < count; ++i) {
+		*out++ = proj[0];
+		*out++ = proj[i - 1];
+		*out++ = proj[i];
+	}
+	return count - 2;
+}
+
+void tiny3d::ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::Vector3 *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::Vector3 *out)
+{
+	Project(transform, in, count, viewport, out);
+}
+
+void tiny3d::ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::Vertex *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::Vertex *out)
+{
+	Project(transform, in, count, viewport, out);
+}
+
+void tiny3d::ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::LVertex *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::LVertex *out)
+{
+	Project(transform, in, count, viewport, out);
+}
+
+tiny3d::UInt tiny3d::ProjectTriangle(const tiny3d::Matrix4x4 &transform, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, tiny3d::URect viewport, tiny3d::Vertex *out, bool clip_far)
+{
+	return ProjectClipped(transform, a, b, c, viewport, out, clip_far);
+}
+
+tiny3d::UInt tiny3d::ProjectTriangle(const tiny3d::Matrix4x4 &transform, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, tiny3d::URect viewport, tiny3d::LVertex *out, bool clip_far)
+{
+	return ProjectClipped(transform, a, b, c, viewport, out, clip_far);
+}
@@ -0,0 +1,45 @@
+#ifndef TINY_TRANSFORM_H
+#define TINY_TRANSFORM_H
+
+#include "tiny_system.h"
+#include "tiny_math.h"
+#include "tiny_structs.h"
+
+namespace tiny3d
+{
+
+// @algo ProjectVertices
+// @info Transforms model space vertices to the screen space vertices expected by the Draw functions. Vertices are transformed TINY_WIDTH at a time with the coordinates of each lane in separate registers. Texture coordinates, colors and light map coordinates are copied as-is.
+// @in
+//   transform -> The combined projection and model view matrix mapping model space to homogeneous clip space. See tiny3d::Perspective.
+//   in -> The model space vertices.
+//   count -> The number of vertices.
+//   viewport -> The rectangle of the destination that clip space [-1, 1] is mapped to. Clip space y points up, screen space y points down.
+// @out
+//   out -> The screen space vertices. x and y are in pixels, z is the clip space w (the distance along the view direction for perspective projections). May be the same array as in.
+// @note Vertices are divided by w without clipping, so triangles crossing the plane of the eye must be clipped before being transformed.
+void ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::Vector3 *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::Vector3 *out);
+void ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::Vertex *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::Vertex *out);
+void ProjectVertices(const tiny3d::Matrix4x4 &transform, const tiny3d::LVertex *in, tiny3d::UInt count, tiny3d::URect viewport, tiny3d::LVertex *out);
+
+// @algo MaxClippedTriangles
+// @info A triangle clipped against six planes has at most nine vertices.
+// @out The maximum number of triangles ProjectTriangle can output for a single triangle.
+constexpr tiny3d::UInt MaxClippedTriangles( void ) { return 7; }
+
+// @algo ProjectTriangle
+// @info Transforms a model space triangle to screen space like ProjectVertices, clipping it in homogeneous clip space first. The triangle is always clipped against the near plane, and against the far plane if requested. It is not clipped against the edges of the viewport, only against a guard band of +-8192 pixels that keeps screen space coordinates within the range the rasterizer handles, so the dst_rect of the Draw functions does the rest. Attributes are interpolated linearly in clip space at the new vertices.
+// @in
+//   transform -> The combined projection and model view matrix mapping model space to homogeneous clip space. The near and far planes are where clip space z equals -w and w respectively. See tiny3d::Perspective.
+//   a, b, c -> The model space vertices of the triangle.
+//   viewport -> The rectangle of the destination that clip space [-1, 1] is mapped to.
+//   clip_far -> Clip against the far plane.
+// @out
+//   out -> The clipped screen space triangles, three vertices each, wound the same way as the input triangle. Must hold at least 3 * MaxClippedTriangles() vertices.
+//   RETURN -> The number of triangles written to out. 0 if the triangle is entirely clipped or the viewport is empty.
+tiny3d::UInt ProjectTriangle(const tiny3d::Matrix4x4 &transform, const tiny3d::Vertex &a, const tiny3d::Vertex &b, const tiny3d::Vertex &c, tiny3d::URect viewport, tiny3d::Vertex *out, bool clip_far = false);
+tiny3d::UInt ProjectTriangle(const tiny3d::Matrix4x4 &transform, const tiny3d::LVertex &a, const tiny3d::LVertex &b, const tiny3d::LVertex &c, tiny3d::URect viewport, tiny3d::LVertex *out, bool clip_far = false);
+
+}
+
+#endif // TINY_TRANSFORM_H